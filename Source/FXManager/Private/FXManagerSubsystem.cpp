@@ -2,12 +2,90 @@
 
 
 #include "FXManagerSubsystem.h"
+#include "EffectPackAsset.h"
+#include "FXSpawnBackend.h"
 #include "GameplayTagAssetInterface.h"
-#include "NiagaraFunctionLibrary.h"
-#include "NiagaraSystem.h"
-#include "NiagaraComponent.h"
+#include "AudioDevice.h"
+#include "Camera/PlayerCameraManager.h"
+#include "GameFramework/PlayerController.h"
 #include "Kismet/GameplayStatics.h"
+#include "NiagaraComponent.h"
 
+DECLARE_STATS_GROUP(TEXT("FX Manager"), STATGROUP_FXManager, STATCAT_Advanced);
+DECLARE_CYCLE_STAT(TEXT("Play Effect At Location"), STAT_FXManager_PlayEffectAtLocation, STATGROUP_FXManager);
+DECLARE_CYCLE_STAT(TEXT("Play Effect Attached"), STAT_FXManager_PlayEffectAttached, STATGROUP_FXManager);
+DECLARE_CYCLE_STAT(TEXT("Play Effect One Shot"), STAT_FXManager_PlayEffectOneShot, STATGROUP_FXManager);
+DECLARE_CYCLE_STAT(TEXT("Play Effect One Shot Attached"), STAT_FXManager_PlayEffectOneShotAttached, STATGROUP_FXManager);
+DECLARE_CYCLE_STAT(TEXT("Play Effect Following"), STAT_FXManager_PlayEffectFollowing, STATGROUP_FXManager);
+DECLARE_CYCLE_STAT(TEXT("Play Effect By Id"), STAT_FXManager_PlayEffectById, STATGROUP_FXManager);
+DECLARE_CYCLE_STAT(TEXT("Play Effect Attached By Id"), STAT_FXManager_PlayEffectAttachedById, STATGROUP_FXManager);
+DECLARE_CYCLE_STAT(TEXT("Play Effect One Shot By Id"), STAT_FXManager_PlayEffectOneShotById, STATGROUP_FXManager);
+DECLARE_CYCLE_STAT(TEXT("Play Effect One Shot Attached By Id"), STAT_FXManager_PlayEffectOneShotAttachedById, STATGROUP_FXManager);
+DECLARE_CYCLE_STAT(TEXT("Update Following Packs"), STAT_FXManager_UpdateFollowingPacks, STATGROUP_FXManager);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Following Packs"), STAT_FXManager_NumFollowingPacks, STATGROUP_FXManager);
+DECLARE_CYCLE_STAT(TEXT("Stop Active Packs"), STAT_FXManager_StopActivePacks, STATGROUP_FXManager);
+DECLARE_CYCLE_STAT(TEXT("Restart Pack"), STAT_FXManager_RestartPack, STATGROUP_FXManager);
+DECLARE_CYCLE_STAT(TEXT("Process Pending Deactivations"), STAT_FXManager_ProcessPendingDeactivations, STATGROUP_FXManager);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pending Deactivations"), STAT_FXManager_NumPendingDeactivations, STATGROUP_FXManager);
+DECLARE_CYCLE_STAT(TEXT("Update Pack Significance"), STAT_FXManager_UpdatePackSignificance, STATGROUP_FXManager);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Throttled Active Packs"), STAT_FXManager_NumThrottledPacks, STATGROUP_FXManager);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Culled VFX"), STAT_FXManager_NumCulledVFX, STATGROUP_FXManager);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pending Culled VFX"), STAT_FXManager_NumPendingCulledVFX, STATGROUP_FXManager);
+
+static float GDeactivationBudgetMs = 0.5f;
+static FAutoConsoleVariableRef CVarDeactivationBudgetMs(
+	TEXT("FXManager.DeactivationBudgetMs"),
+	GDeactivationBudgetMs,
+	TEXT("Milliseconds per tick the FX Manager may spend deactivating components of packs stopped with deferred deactivation."),
+	ECVF_Default);
+
+static bool GSignificanceEnabled = true;
+static FAutoConsoleVariableRef CVarSignificanceEnabled(
+	TEXT("FXManager.Significance.Enabled"),
+	GSignificanceEnabled,
+	TEXT("Whether active packs are throttled based on their distance and visibility to the local views."),
+	ECVF_Default);
+
+static float GSignificanceUpdateInterval = 0.25f;
+static FAutoConsoleVariableRef CVarSignificanceUpdateInterval(
+	TEXT("FXManager.Significance.UpdateInterval"),
+	GSignificanceUpdateInterval,
+	TEXT("Seconds between scoring active packs by significance."),
+	ECVF_Default);
+
+static float GSignificanceReducedDistance = 3000.f;
+static FAutoConsoleVariableRef CVarSignificanceReducedDistance(
+	TEXT("FXManager.Significance.ReducedDistance"),
+	GSignificanceReducedDistance,
+	TEXT("Active packs farther than this from every local view, or not recently rendered, tick at the reduced interval."),
+	ECVF_Default);
+
+static float GSignificancePauseDistance = 8000.f;
+static FAutoConsoleVariableRef CVarSignificancePauseDistance(
+	TEXT("FXManager.Significance.PauseDistance"),
+	GSignificancePauseDistance,
+	TEXT("Active packs farther than this from every local view pause their Niagara systems and sounds."),
+	ECVF_Default);
+
+static float GSignificanceReducedTickInterval = 0.1f;
+static FAutoConsoleVariableRef CVarSignificanceReducedTickInterval(
+	TEXT("FXManager.Significance.ReducedTickInterval"),
+	GSignificanceReducedTickInterval,
+	TEXT("Tick interval in seconds applied to the Cascade and solo Niagara systems of reduced significance packs. ")
+	TEXT("Other Niagara systems are ticked by their world manager, so they are only throttled by pausing once a pack is insignificant."),
+	ECVF_Default);
+
+static FAutoConsoleCommand CmdUseNullSpawnBackend(
+	TEXT("FXManager.UseNullSpawnBackend"),
+	TEXT("1 swaps the FX Manager to a backend that spawns no real components, 0 restores the engine backend."),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		if(UFXManagerSubsystem* FXManager = UFXManagerSubsystem::GetFXManager())
+		{
+			const bool bUseNullBackend = Args.Num() > 0 && FCString::Atoi(*Args[0]) != 0;
+			FXManager->SetSpawnBackend(bUseNullBackend ? MakeShared<FNullFXSpawnBackend>() : nullptr);
+		}
+	}));
 
 const TMap<EAttachmentRule, EAttachLocation::Type> UFXManagerSubsystem::AttachmentMap =
 {
@@ -24,13 +102,59 @@ bool UFXManagerSubsystem::ShouldCreateSubsystem(UObject* Outer) const
 void UFXManagerSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 {
 	Super::Initialize(Collection);
+
+	SpawnBackend = MakeShared<FEngineFXSpawnBackend>();
 }
 
 void UFXManagerSubsystem::Deinitialize()
 {
+	SpawnBackend.Reset();
+
 	Super::Deinitialize();
 }
 
+void UFXManagerSubsystem::SetSpawnBackend(TSharedPtr<IFXSpawnBackend> InSpawnBackend)
+{
+	SpawnBackend = InSpawnBackend ? InSpawnBackend : MakeShared<FEngineFXSpawnBackend>();
+}
+
+void UFXManagerSubsystem::Tick(float DeltaTime)
+{
+	if(SpawnBackend && SpawnBackend->IsTickable())
+	{
+		SpawnBackend->Tick(DeltaTime);
+	}
+
+	UpdateFollowingPacks(DeltaTime);
+	UpdatePendingCulledVFX(DeltaTime);
+	ProcessPendingDeactivations();
+
+	TimeSinceSignificanceUpdate += DeltaTime;
+	if(TimeSinceSignificanceUpdate >= GSignificanceUpdateInterval)
+	{
+		UpdatePackSignificance();
+		TimeSinceSignificanceUpdate = 0.f;
+	}
+}
+
+ETickableTickType UFXManagerSubsystem::GetTickableTickType() const
+{
+	/* Our class default object should never tick */
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+bool UFXManagerSubsystem::IsTickable() const
+{
+	return !FollowingEffectPacks.IsEmpty() || !PendingDeactivations.IsEmpty() || !PendingCulledVFX.IsEmpty()
+		|| !ActiveEffectPacks.IsEmpty()
+		|| (SpawnBackend && SpawnBackend->IsTickable());
+}
+
+TStatId UFXManagerSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UFXManagerSubsystem, STATGROUP_FXManager);
+}
+
 UFXManagerSubsystem* UFXManagerSubsystem::GetFXManager()
 {
 	if(GEngine)
@@ -44,23 +168,115 @@ UFXManagerSubsystem* UFXManagerSubsystem::GetFXManager()
 FActiveEffectPackHandle UFXManagerSubsystem::PlayEffectAtLocation(AActor* SourceActor, AActor* TargetActor,
                                                          const FEffectPack& EffectPack, EEffectActivationType ActivationType, FTransform Transform)
 {
+	SCOPE_CYCLE_COUNTER(STAT_FXManager_PlayEffectAtLocation);
+
+	if(!EffectPack.IsValid())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Effect Pack is Empty."))
+		return FActiveEffectPackHandle();
+	}
+
+	if(!SourceActor)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Source Actor is invalid!"))
+		return FActiveEffectPackHandle();
+	}
+
+	return Internal_PlayEffectAtLocation(SourceActor, TargetActor, EffectPack, ActivationType, Transform);
+}
+
+FActiveEffectPackHandle UFXManagerSubsystem::PlayEffectAttached(AActor* SourceActor, AActor* TargetActor,
+	USceneComponent* AttachComponent, const FEffectPack& EffectPack, EEffectActivationType ActivationType, bool bKeepAlive)
+{
+	SCOPE_CYCLE_COUNTER(STAT_FXManager_PlayEffectAttached);
+
+	if (!EffectPack.IsValid())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Effect Pack is Empty."))
+			return FActiveEffectPackHandle();
+	}
+
+	if (!SourceActor || !AttachComponent)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Source Actor or Attach Component is invalid!"))
+			return FActiveEffectPackHandle();
+	}
+
+	return Internal_PlayEffectAttached(SourceActor, TargetActor, AttachComponent, EffectPack, ActivationType, bKeepAlive);
+}
+
+FActiveEffectPackHandle UFXManagerSubsystem::PlayEffectFollowing(AActor* SourceActor, AActor* TargetActor,
+	USceneComponent* FollowComponent, const FEffectPack& EffectPack, EEffectActivationType ActivationType,
+	const FFollowSettings& FollowSettings)
+{
+	SCOPE_CYCLE_COUNTER(STAT_FXManager_PlayEffectFollowing);
+
 	if(!EffectPack.IsValid())
 	{
 		UE_LOG(LogTemp, Warning, TEXT("Effect Pack is Empty."))
 		return FActiveEffectPackHandle();
 	}
 
+	if(!SourceActor || !FollowComponent)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Source Actor or Follow Component is invalid!"))
+		return FActiveEffectPackHandle();
+	}
+
+	return Internal_PlayEffectFollowing(SourceActor, TargetActor, FollowComponent, EffectPack, ActivationType, FollowSettings);
+}
+
+FActiveEffectPackHandle UFXManagerSubsystem::PlayEffectById(AActor* SourceActor, AActor* TargetActor, FGameplayTag PackId,
+	EEffectActivationType ActivationType, FTransform Transform)
+{
+	SCOPE_CYCLE_COUNTER(STAT_FXManager_PlayEffectById);
+
+	const FEffectPack* EffectPack = FindRegisteredEffectPack(PackId);
+	if(!EffectPack)
+	{
+		return FActiveEffectPackHandle();
+	}
+
 	if(!SourceActor)
 	{
 		UE_LOG(LogTemp, Warning, TEXT("Source Actor is invalid!"))
 		return FActiveEffectPackHandle();
 	}
 
+	return Internal_PlayEffectAtLocation(SourceActor, TargetActor, *EffectPack, ActivationType, Transform);
+}
+
+FActiveEffectPackHandle UFXManagerSubsystem::PlayEffectAttachedById(AActor* SourceActor, AActor* TargetActor,
+	USceneComponent* AttachComponent, FGameplayTag PackId, EEffectActivationType ActivationType, bool bKeepAlive)
+{
+	SCOPE_CYCLE_COUNTER(STAT_FXManager_PlayEffectAttachedById);
+
+	const FEffectPack* EffectPack = FindRegisteredEffectPack(PackId);
+	if(!EffectPack)
+	{
+		return FActiveEffectPackHandle();
+	}
+
+	if(!SourceActor || !AttachComponent)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Source Actor or Attach Component is invalid!"))
+		return FActiveEffectPackHandle();
+	}
+
+	return Internal_PlayEffectAttached(SourceActor, TargetActor, AttachComponent, *EffectPack, ActivationType, bKeepAlive);
+}
+
+FActiveEffectPackHandle UFXManagerSubsystem::Internal_PlayEffectAtLocation(AActor* SourceActor, AActor* TargetActor,
+	const FEffectPack& EffectPack, EEffectActivationType ActivationType, const FTransform& Transform)
+{
 	FActiveEffectPack ActivePack = FActiveEffectPack(GenerateNewActivePackId(), SourceActor, TargetActor, nullptr, ActivationType);
 
 	const FGameplayTagContainer SourceTags = GetActorTags(SourceActor);
 	const FGameplayTagContainer TargetTags = GetActorTags(TargetActor);
 
+	/* Active packs are kept while culled effects are still waiting to become relevant, even if nothing spawned yet */
+	bool bHasPendingVFX = false;
+
 	for(const FVFXData& VfxData : EffectPack.VFXData)
 	{
 		/* Go to the next effect data if this one is unable to play */
@@ -69,7 +285,10 @@ FActiveEffectPackHandle UFXManagerSubsystem::PlayEffectAtLocation(AActor* Source
 			continue;
 		}
 
-		ActivePack.AddActiveVFX(SpawnVFXDataAtLocation(VfxData, SourceActor, Transform), VfxData.AccessTag);
+		bool bCulled = false;
+		UFXSystemComponent* Vfx = SpawnVFXDataAtLocation(VfxData, SourceActor, Transform, &bCulled);
+		ActivePack.AddVFXResult(Vfx, VfxData.AccessTag, bCulled);
+		bHasPendingVFX |= bCulled && AddPendingCulledVFX(ActivePack, VfxData, SourceActor, nullptr, Transform);
 	}
 
 	for(const FSFXData& SfxData : EffectPack.SFXData)
@@ -80,38 +299,39 @@ FActiveEffectPackHandle UFXManagerSubsystem::PlayEffectAtLocation(AActor* Source
 			continue;
 		}
 
-		ActivePack.AddActiveSound(SpawnSFXDataAtLocation(SfxData, SourceActor, Transform), SfxData.AccessTag);
+		ESoundSpawnResult Result;
+		UAudioComponent* Sound = SpawnSFXDataAtLocation(SfxData, SourceActor, Transform, &Result);
+		ActivePack.AddSoundResult(Sound, SfxData.AccessTag, Result);
 	}
 
-	if(!ActivePack.IsActive())
+	if(!ActivePack.IsActive() && !bHasPendingVFX)
 	{
-		return FActiveEffectPackHandle();
+		return ActivePack.CreateInactiveHandle();
 	}
 
-	ActivationType == EEffectActivationType::Active ? ActiveEffectPacks.Add(ActivePack) : AddInstantPack(SourceActor, ActivePack);
+	ActivationType == EEffectActivationType::Active ? AddActivePack(ActivePack) : AddInstantPack(SourceActor, ActivePack);
 	return ActivePack.CreateHandle();
 }
 
-FActiveEffectPackHandle UFXManagerSubsystem::PlayEffectAttached(AActor* SourceActor, AActor* TargetActor,
-	USceneComponent* AttachComponent, const FEffectPack& EffectPack, EEffectActivationType ActivationType)
+FActiveEffectPackHandle UFXManagerSubsystem::Internal_PlayEffectAttached(AActor* SourceActor, AActor* TargetActor,
+	USceneComponent* AttachComponent, const FEffectPack& EffectPack, EEffectActivationType ActivationType, bool bKeepAlive)
 {
-	if (!EffectPack.IsValid())
-	{
-		UE_LOG(LogTemp, Warning, TEXT("Effect Pack is Empty."))
-			return FActiveEffectPackHandle();
-	}
+	FActiveEffectPack ActivePack = FActiveEffectPack(GenerateNewActivePackId(), SourceActor, TargetActor, AttachComponent, ActivationType);
 
-	if (!SourceActor || !AttachComponent)
+	/* Instant packs are dropped on the next tick, so there would be nothing left to restart */
+	if(bKeepAlive && ActivationType != EEffectActivationType::Active)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("Source Actor or Attach Component is invalid!"))
-			return FActiveEffectPackHandle();
+		UE_LOG(LogTemp, Warning, TEXT("Only Active effect packs can be kept alive."))
+		bKeepAlive = false;
 	}
 
-	FActiveEffectPack ActivePack = FActiveEffectPack(GenerateNewActivePackId(), SourceActor, TargetActor, AttachComponent, ActivationType);
+	ActivePack.bKeepAlive = bKeepAlive;
 
 	const FGameplayTagContainer SourceTags = GetActorTags(SourceActor);
 	const FGameplayTagContainer TargetTags = GetActorTags(TargetActor);
 
+	bool bHasPendingVFX = false;
+
 	for (const FVFXData& VfxData : EffectPack.VFXData)
 	{
 		/* Go to the next effect data if this one is unable to play */
@@ -120,7 +340,11 @@ FActiveEffectPackHandle UFXManagerSubsystem::PlayEffectAttached(AActor* SourceAc
 			continue;
 		}
 
-		ActivePack.AddActiveVFX(SpawnVFXDataAtComponent(VfxData, SourceActor, AttachComponent), VfxData.AccessTag);
+		bool bCulled = false;
+		UFXSystemComponent* Vfx = SpawnVFXDataAtComponent(VfxData, SourceActor, AttachComponent, &bCulled, bKeepAlive);
+		ActivePack.AddVFXResult(Vfx, VfxData.AccessTag, bCulled);
+		ActivePack.AddSocketBinding(Vfx, VfxData);
+		bHasPendingVFX |= bCulled && AddPendingCulledVFX(ActivePack, VfxData, SourceActor, AttachComponent, FTransform::Identity);
 	}
 
 	for (const FSFXData& SfxData : EffectPack.SFXData)
@@ -131,227 +355,1177 @@ FActiveEffectPackHandle UFXManagerSubsystem::PlayEffectAttached(AActor* SourceAc
 			continue;
 		}
 
-		ActivePack.AddActiveSound(SpawnSFXDataAtComponent(SfxData, SourceActor, AttachComponent), SfxData.AccessTag);
+		ESoundSpawnResult Result;
+		UAudioComponent* Sound = SpawnSFXDataAtComponent(SfxData, SourceActor, AttachComponent, &Result, bKeepAlive);
+		ActivePack.AddSoundResult(Sound, SfxData.AccessTag, Result);
+		ActivePack.AddSocketBinding(Sound, SfxData);
+		ActivePack.AddKeptAliveSound(Sound, SfxData);
 	}
 
-	if (!ActivePack.IsActive())
+	if (!ActivePack.IsActive() && !bHasPendingVFX)
 	{
-		return FActiveEffectPackHandle();
+		return ActivePack.CreateInactiveHandle();
 	}
 
-	ActivationType == EEffectActivationType::Active ? ActiveEffectPacks.Add(ActivePack) : AddInstantPack(SourceActor, ActivePack);
+	ActivationType == EEffectActivationType::Active ? AddActivePack(ActivePack) : AddInstantPack(SourceActor, ActivePack);
 	return ActivePack.CreateHandle();
 }
 
-void UFXManagerSubsystem::StopActivePack(const FActiveEffectPackHandle& Handle)
+FActiveEffectPackHandle UFXManagerSubsystem::Internal_PlayEffectFollowing(AActor* SourceActor, AActor* TargetActor,
+	USceneComponent* FollowComponent, const FEffectPack& EffectPack, EEffectActivationType ActivationType,
+	const FFollowSettings& FollowSettings)
 {
-	for(auto Iterator = ActiveEffectPacks.CreateIterator(); Iterator; ++Iterator)
+	FActiveEffectPack ActivePack = FActiveEffectPack(GenerateNewActivePackId(), SourceActor, TargetActor, nullptr, ActivationType);
+	FFollowingEffectPack FollowingPack = FFollowingEffectPack(ActivePack.Id, FollowComponent, FollowSettings);
+
+	const FGameplayTagContainer SourceTags = GetActorTags(SourceActor);
+	const FGameplayTagContainer TargetTags = GetActorTags(TargetActor);
+
+	/* Effects are spawned unattached at their socket, our tick keeps them there afterwards */
+	for(const FVFXData& VfxData : EffectPack.VFXData)
 	{
-		FActiveEffectPack& Pack = ActiveEffectPacks[Iterator.GetIndex()];
-		if(Pack.Id == Handle.GetId())
+		if(!VfxData.CanPlay(SourceTags, TargetTags))
 		{
-			Pack.Invalidate();
-			Iterator.RemoveCurrent();
-			return;
+			continue;
 		}
-	}
-}
 
-void UFXManagerSubsystem::StopActivePacks(const TArray<FActiveEffectPackHandle>& Handles)
-{
-	/* Cache all Handle Id's using a Set, this keeps us from having to iterate over our active effect pack
-	 * array for each handle, O(n) instead of O(n^2) */
-	TSet<int> PackIdsToRemove;
+		bool bCulled = false;
+		UFXSystemComponent* Vfx = SpawnVFXDataAtLocation(VfxData, SourceActor, FollowComponent->GetSocketTransform(VfxData.AttachmentData.SocketName), &bCulled);
+		ActivePack.AddVFXResult(Vfx, VfxData.AccessTag, bCulled);
+		FollowingPack.AddEffect(Vfx, VfxData);
 
-	// Iterate through all our active effect packs and cache their Id's
-	for(int i = 0; i < Handles.Num(); ++i)
-	{
-		const FActiveEffectPackHandle& Handle = Handles[i];
-		PackIdsToRemove.Add(Handle.GetId());
+		if(bCulled && AddPendingCulledVFX(ActivePack, VfxData, SourceActor, FollowComponent, FTransform::Identity, true))
+		{
+			++FollowingPack.NumPendingEffects;
+		}
 	}
 
-	// Check if the handles Id was in our cached set, invalidate the pack, and remove the current index
-	for(auto Iterator = ActiveEffectPacks.CreateIterator(); Iterator; ++Iterator)
+	for(const FSFXData& SfxData : EffectPack.SFXData)
 	{
-		FActiveEffectPack& Pack = ActiveEffectPacks[Iterator.GetIndex()];
-		if(PackIdsToRemove.Contains(Pack.Id))
+		if(!SfxData.CanPlay(SourceTags, TargetTags))
 		{
-			Pack.Invalidate();
-			Iterator.RemoveCurrent();
+			continue;
+		}
+
+		ESoundSpawnResult Result;
+		UAudioComponent* Sound = SpawnSFXDataAtLocation(SfxData, SourceActor, FollowComponent->GetSocketTransform(SfxData.AttachmentData.SocketName), &Result);
+		ActivePack.AddSoundResult(Sound, SfxData.AccessTag, Result);
+
+		/* Two dimensional sounds have no position to keep up to date */
+		if(SfxData.AudioType == EAudioType::ThreeDimensional)
+		{
+			FollowingPack.AddEffect(Sound, SfxData);
 		}
 	}
-}
 
-UFXSystemComponent* UFXManagerSubsystem::GetVfxSystemComponentByTag(const FActiveEffectPackHandle& Handle,
-	FGameplayTag Tag)
-{
-	return Internal_GetVfxSystemComponent(Handle, [Tag](const FActiveEffect<UFXSystemComponent*>& ActiveEffect)
+	/* Active packs are kept while culled effects are still waiting to become relevant, even if nothing spawned yet */
+	if(!ActivePack.IsActive() && FollowingPack.NumPendingEffects == 0)
 	{
-		return ActiveEffect.AccessTag == Tag;
-	});
-}
+		return ActivePack.CreateInactiveHandle();
+	}
 
-UAudioComponent* UFXManagerSubsystem::GetSfxSystemComponentByTag(const FActiveEffectPackHandle& Handle,
-	FGameplayTag Tag)
-{
-	return Internal_FindSfxSystemComponent(Handle, [Tag](const FActiveEffect<UAudioComponent*>& ActiveEffect)
+	if(FollowingPack.Effects.Num() > 0 || FollowingPack.NumPendingEffects > 0)
 	{
-		return ActiveEffect.AccessTag == Tag;
-	});
+		FollowingPack.UpdateTransforms();
+		FollowingEffectPacks.Add(MoveTemp(FollowingPack));
+	}
+
+	ActivationType == EEffectActivationType::Active ? AddActivePack(ActivePack) : AddInstantPack(SourceActor, ActivePack);
+	return ActivePack.CreateHandle();
 }
 
-UFXSystemComponent* UFXManagerSubsystem::SpawnVFXDataAtLocation(const FVFXData VFXData, const AActor* SourceActor, const FTransform& Transform) const
+void UFXManagerSubsystem::PlayEffectOneShot(AActor* SourceActor, AActor* TargetActor, const FEffectPack& EffectPack,
+	FTransform Transform)
 {
+	SCOPE_CYCLE_COUNTER(STAT_FXManager_PlayEffectOneShot);
 
-	UFXSystemAsset* Asset = VFXData.ParticleSystem;
-	if(!Asset)
-	{
-		return nullptr;
-	}
-
-	const FVector Location = Transform.GetLocation() + VFXData.AttachmentData.RelativeTransform.GetLocation();
-	const FRotator Rotation = FRotator(Transform.GetRotation() + VFXData.AttachmentData.RelativeTransform.GetRotation());
-	const FVector Scale = Transform.GetScale3D() * VFXData.AttachmentData.RelativeTransform.GetScale3D();
-
-	if(UParticleSystem* Cascade = Cast<UParticleSystem>(Asset))
+	if(!EffectPack.IsValid())
 	{
-		return UGameplayStatics::SpawnEmitterAtLocation
-		(SourceActor, Cascade, Location, Rotation, Scale, true);
+		UE_LOG(LogTemp, Warning, TEXT("Effect Pack is Empty."))
+		return;
 	}
 
-	if(UNiagaraSystem* Niagara = Cast<UNiagaraSystem>(Asset))
+	if(!SourceActor)
 	{
-		return Cast<UFXSystemComponent>(UNiagaraFunctionLibrary::SpawnSystemAtLocation(SourceActor, Niagara, 
-			Location, Rotation, Scale, true, true));
+		UE_LOG(LogTemp, Warning, TEXT("Source Actor is invalid!"))
+		return;
 	}
 
-	return nullptr;
+	Internal_PlayEffectOneShot(SourceActor, TargetActor, EffectPack, Transform);
 }
 
-UAudioComponent* UFXManagerSubsystem::SpawnSFXDataAtLocation(const FSFXData SFXData, const AActor* SourceActor, const FTransform& Transform) const
+void UFXManagerSubsystem::PlayEffectOneShotById(AActor* SourceActor, AActor* TargetActor, FGameplayTag PackId,
+	FTransform Transform)
 {
+	SCOPE_CYCLE_COUNTER(STAT_FXManager_PlayEffectOneShotById);
 
-	USoundBase* Asset = SFXData.Sound;
-	if(!Asset)
-	{
-		return nullptr;
-	}
-
-	if(SFXData.AudioType == EAudioType::TwoDimensional)
+	const FEffectPack* EffectPack = FindRegisteredEffectPack(PackId);
+	if(!EffectPack)
 	{
-		return UGameplayStatics::SpawnSound2D(SourceActor, Asset);
+		return;
 	}
 
-	if(SFXData.AudioType == EAudioType::ThreeDimensional)
+	if(!SourceActor)
 	{
-		const FVector Location = Transform.GetLocation() + SFXData.AttachmentData.RelativeTransform.GetLocation();
-		const FRotator Rotation = FRotator(Transform.GetRotation() + SFXData.AttachmentData.RelativeTransform.GetRotation());
-		return UGameplayStatics::SpawnSoundAtLocation(SourceActor, Asset, Location, Rotation);
+		UE_LOG(LogTemp, Warning, TEXT("Source Actor is invalid!"))
+		return;
 	}
 
-	return nullptr;
+	Internal_PlayEffectOneShot(SourceActor, TargetActor, *EffectPack, Transform);
 }
 
-UFXSystemComponent* UFXManagerSubsystem::SpawnVFXDataAtComponent(const FVFXData VFXData, const AActor* SourceActor,
-	USceneComponent* AttachComponent) const
+void UFXManagerSubsystem::Internal_PlayEffectOneShot(AActor* SourceActor, AActor* TargetActor, const FEffectPack& EffectPack,
+	const FTransform& Transform)
 {
+	const FGameplayTagContainer SourceTags = GetActorTags(SourceActor);
+	const FGameplayTagContainer TargetTags = GetActorTags(TargetActor);
 
-	UFXSystemAsset* Asset = VFXData.ParticleSystem;
-	if (!Asset)
+	/* Spawned components are never stored, they are owned by the world and released once they finish */
+	for(const FVFXData& VfxData : EffectPack.VFXData)
 	{
-		return nullptr;
+		if(VfxData.CanPlay(SourceTags, TargetTags))
+		{
+			SpawnVFXDataAtLocation(VfxData, SourceActor, Transform);
+		}
 	}
 
-	/* If our attach type is at socket location, return our effect at location instead of trying to attach */
-	if(VFXData.AttachmentData.AttachType == EAttachType::AtSocketLocation)
+	for(const FSFXData& SfxData : EffectPack.SFXData)
 	{
-		return SpawnVFXDataAtLocation(VFXData, SourceActor, AttachComponent->GetSocketTransform(VFXData.AttachmentData.SocketName));
+		if(SfxData.CanPlay(SourceTags, TargetTags))
+		{
+			SpawnSFXDataAtLocation(SfxData, SourceActor, Transform);
+		}
 	}
+}
 
-	const FTransform RelativeTransform = VFXData.GetRelativeTransform();
-	const EAttachLocation::Type AttachRule = GetAttachLocationType(VFXData.AttachmentData.AttachmentRule);
-	
+void UFXManagerSubsystem::PlayEffectOneShotAttached(AActor* SourceActor, AActor* TargetActor,
+	USceneComponent* AttachComponent, const FEffectPack& EffectPack)
+{
+	SCOPE_CYCLE_COUNTER(STAT_FXManager_PlayEffectOneShotAttached);
 
-	if (UParticleSystem* Cascade = Cast<UParticleSystem>(Asset))
+	if(!EffectPack.IsValid())
 	{
-		return UGameplayStatics::SpawnEmitterAttached(Cascade, AttachComponent, VFXData.AttachmentData.SocketName, RelativeTransform.GetLocation(),
-			FRotator(RelativeTransform.GetRotation()), RelativeTransform.GetScale3D(), AttachRule, true, EPSCPoolMethod::AutoRelease, true);
+		UE_LOG(LogTemp, Warning, TEXT("Effect Pack is Empty."))
+		return;
 	}
 
-	if (UNiagaraSystem* Niagara = Cast<UNiagaraSystem>(Asset))
+	if(!SourceActor || !AttachComponent)
 	{
-		return Cast<UFXSystemComponent>(UNiagaraFunctionLibrary::SpawnSystemAttached(Niagara, AttachComponent, VFXData.AttachmentData.SocketName,
-			RelativeTransform.GetLocation(), FRotator(RelativeTransform.GetRotation()),
-			AttachRule, true, true, ENCPoolMethod::AutoRelease));
+		UE_LOG(LogTemp, Warning, TEXT("Source Actor or Attach Component is invalid!"))
+		return;
 	}
 
-	return nullptr;
+	Internal_PlayEffectOneShotAttached(SourceActor, TargetActor, AttachComponent, EffectPack);
 }
 
-UAudioComponent* UFXManagerSubsystem::SpawnSFXDataAtComponent(const FSFXData SFXData, const AActor* SourceActor,
-	USceneComponent* AttachComponent) const
+void UFXManagerSubsystem::PlayEffectOneShotAttachedById(AActor* SourceActor, AActor* TargetActor,
+	USceneComponent* AttachComponent, FGameplayTag PackId)
 {
+	SCOPE_CYCLE_COUNTER(STAT_FXManager_PlayEffectOneShotAttachedById);
 
-	USoundBase* Asset = SFXData.Sound;
-	if (!Asset)
+	const FEffectPack* EffectPack = FindRegisteredEffectPack(PackId);
+	if(!EffectPack)
 	{
-		return nullptr;
+		return;
 	}
 
-	/* If our attach type is at socket location or we are playing a generic two dimensional sound, play it at location instead of attached */
-	if (SFXData.AttachmentData.AttachType == EAttachType::AtSocketLocation || SFXData.AudioType == EAudioType::TwoDimensional)
+	if(!SourceActor || !AttachComponent)
 	{
-		return SpawnSFXDataAtLocation(SFXData, SourceActor, AttachComponent->GetSocketTransform(SFXData.AttachmentData.SocketName));
+		UE_LOG(LogTemp, Warning, TEXT("Source Actor or Attach Component is invalid!"))
+		return;
 	}
 
-	const FTransform RelativeTransform = SFXData.GetRelativeTransform();
-	const EAttachLocation::Type AttachRule = GetAttachLocationType(SFXData.AttachmentData.AttachmentRule);
-
-	return UGameplayStatics::SpawnSoundAttached(Asset, AttachComponent, SFXData.AttachmentData.SocketName,
-		RelativeTransform.GetLocation(), FRotator(RelativeTransform.GetRotation()), AttachRule, false);
-
+	Internal_PlayEffectOneShotAttached(SourceActor, TargetActor, AttachComponent, *EffectPack);
 }
 
-
-FActiveEffectPack& UFXManagerSubsystem::GetActivePack(const FActiveEffectPackHandle& Handle)
+void UFXManagerSubsystem::Internal_PlayEffectOneShotAttached(AActor* SourceActor, AActor* TargetActor,
+	USceneComponent* AttachComponent, const FEffectPack& EffectPack)
 {
-	FActiveEffectPack TempPack;
-	if(!Handle.IsValid())
+	const FGameplayTagContainer SourceTags = GetActorTags(SourceActor);
+	const FGameplayTagContainer TargetTags = GetActorTags(TargetActor);
+
+	for(const FVFXData& VfxData : EffectPack.VFXData)
 	{
-		return TempPack;
+		if(VfxData.CanPlay(SourceTags, TargetTags))
+		{
+			SpawnVFXDataAtComponent(VfxData, SourceActor, AttachComponent);
+		}
 	}
-	
-	/* Get our active or instant pack array based on the activation data from our handle */
-	TArray<FActiveEffectPack>& Array = Handle.GetPackType() == EEffectActivationType::Active ? ActiveEffectPacks : InstantEffectPacks;
-	for (auto Iterator = Array.CreateConstIterator(); Iterator; ++Iterator)
+
+	for(const FSFXData& SfxData : EffectPack.SFXData)
 	{
-		FActiveEffectPack& Pack = Array[Iterator.GetIndex()];
-		if (Pack.Id == Handle.GetId())
+		if(SfxData.CanPlay(SourceTags, TargetTags))
 		{
-			return Pack;
+			SpawnSFXDataAtComponent(SfxData, SourceActor, AttachComponent);
 		}
 	}
-	
-	return TempPack;
 }
 
-void UFXManagerSubsystem::AddInstantPack(const UObject* WorldContextObject, const FActiveEffectPack& ActivePack)
+bool UFXManagerSubsystem::RegisterEffectPack(FGameplayTag PackId, const FEffectPack& EffectPack)
 {
-	InstantEffectPacks.Add(ActivePack);
-	if(!WorldContextObject->GetWorld()->GetTimerManager().IsTimerActive(InstantPackTimerHandle))
+	if(!PackId.IsValid())
 	{
-		InstantPackTimerHandle = WorldContextObject->GetWorld()->GetTimerManager().SetTimerForNextTick(this, &UFXManagerSubsystem::ClearInstantPacks);
+		UE_LOG(LogTemp, Warning, TEXT("Cannot register an Effect Pack without a valid Id."))
+		return false;
 	}
-}
 
-void UFXManagerSubsystem::ClearInstantPacks()
-{
-	InstantEffectPacks.Empty();
+	/* Strip entries that could never spawn so playing the pack by id doesn't need to check them again */
+	FEffectPack ValidatedPack = EffectPack;
+	ValidatedPack.VFXData.RemoveAll([](const FVFXData& VfxData) { return VfxData.ParticleSystem == nullptr; });
+	ValidatedPack.SFXData.RemoveAll([](const FSFXData& SfxData) { return SfxData.Sound == nullptr; });
+
+	if(!ValidatedPack.IsValid())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Effect Pack %s has no playable effects and was not registered."), *PackId.ToString())
+		return false;
+	}
+
+	RegisteredEffectPacks.Add(PackId, MoveTemp(ValidatedPack));
+	return true;
 }
 
-int UFXManagerSubsystem::GenerateNewActivePackId()
+bool UFXManagerSubsystem::RegisterEffectPackAsset(const UEffectPackAsset* Asset)
 {
-	return Internal_NextId++;
+	if(!Asset)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Effect Pack Asset is invalid!"))
+		return false;
+	}
+
+	return RegisterEffectPack(Asset->PackId, Asset->EffectPack);
+}
+
+void UFXManagerSubsystem::UnregisterEffectPack(FGameplayTag PackId)
+{
+	RegisteredEffectPacks.Remove(PackId);
+}
+
+bool UFXManagerSubsystem::IsEffectPackRegistered(FGameplayTag PackId) const
+{
+	return RegisteredEffectPacks.Contains(PackId);
+}
+
+bool UFXManagerSubsystem::RestartPack(const FActiveEffectPackHandle& Handle)
+{
+	SCOPE_CYCLE_COUNTER(STAT_FXManager_RestartPack);
+
+	FActiveEffectPack* Pack = ActiveEffectPacks.FindByPredicate([&Handle](const FActiveEffectPack& ActivePack)
+	{
+		return ActivePack.Id == Handle.GetId();
+	});
+
+	if(!Pack || !Pack->bKeepAlive)
+	{
+		return false;
+	}
+
+	const USceneComponent* AttachComponent = Pack->AttachComponent.Get();
+	if(!AttachComponent)
+	{
+		return false;
+	}
+
+	SetPackSignificance(*Pack, EEffectSignificance::Significant);
+
+	/* Attached effects are already at their socket, effects spawned at a socket location are moved back to it the same
+	 * way they were first placed by SpawnVFXDataAtLocation and SpawnSFXDataAtLocation */
+	for(const FFollowingEffect& Binding : Pack->SocketBindings)
+	{
+		if(USceneComponent* Component = Binding.Component.Get())
+		{
+			const FTransform SocketTransform = AttachComponent->GetSocketTransform(Binding.SocketName);
+			Component->SetWorldLocationAndRotation(SocketTransform.GetLocation() + Binding.RelativeTransform.GetLocation(),
+				FRotator(SocketTransform.GetRotation() + Binding.RelativeTransform.GetRotation()));
+		}
+	}
+
+	for(const FActiveEffect<UFXSystemComponent>& Effect : Pack->ActiveFXSystemComponents)
+	{
+		if(UFXSystemComponent* Component = Effect.Object.Get())
+		{
+			SpawnBackend->RestartVFX(Component);
+		}
+	}
+
+	/* Finished sounds have already left their concurrency group, so a restart has to earn its voice like a new spawn */
+	for(const FKeptAliveSound& Sound : Pack->KeptAliveSounds)
+	{
+		UAudioComponent* Component = Sound.Component.Get();
+		if(!Component)
+		{
+			continue;
+		}
+
+		Component->Stop();
+
+		UAudioComponent* SoundToEvict = nullptr;
+		if(CanSpawnSound(Sound.SFXData, Pack->SourceActor.Get(), Component->GetComponentLocation(), SoundToEvict) == ESoundSpawnResult::Spawned)
+		{
+			SpawnBackend->RestartSound(Component);
+			TrackSoundConcurrency(Sound.SFXData, Component, SoundToEvict);
+		}
+	}
+
+	return true;
+}
+
+void UFXManagerSubsystem::StopActivePack(const FActiveEffectPackHandle& Handle)
+{
+	for(auto Iterator = ActiveEffectPacks.CreateIterator(); Iterator; ++Iterator)
+	{
+		FActiveEffectPack& Pack = ActiveEffectPacks[Iterator.GetIndex()];
+		if(Pack.Id == Handle.GetId())
+		{
+			SetPackSignificance(Pack, EEffectSignificance::Significant);
+			ReleaseKeptAliveComponents(Pack);
+			Pack.Invalidate();
+			Iterator.RemoveCurrent();
+			return;
+		}
+	}
+}
+
+void UFXManagerSubsystem::StopActivePacks(const TArray<FActiveEffectPackHandle>& Handles, bool bDeferDeactivation)
+{
+	SCOPE_CYCLE_COUNTER(STAT_FXManager_StopActivePacks);
+
+	/* Cache all Handle Id's using a Set, this keeps us from having to iterate over our active effect pack
+	 * array for each handle, O(n) instead of O(n^2) */
+	TSet<int> PackIdsToRemove;
+
+	// Iterate through all our active effect packs and cache their Id's
+	for(int i = 0; i < Handles.Num(); ++i)
+	{
+		const FActiveEffectPackHandle& Handle = Handles[i];
+		PackIdsToRemove.Add(Handle.GetId());
+	}
+
+	// Check if the handles Id was in our cached set, invalidate the pack, and remove the current index
+	for(auto Iterator = ActiveEffectPacks.CreateIterator(); Iterator; ++Iterator)
+	{
+		FActiveEffectPack& Pack = ActiveEffectPacks[Iterator.GetIndex()];
+		if(PackIdsToRemove.Contains(Pack.Id))
+		{
+			/* Paused components would never finish deactivating, so restore them first */
+			SetPackSignificance(Pack, EEffectSignificance::Significant);
+			ReleaseKeptAliveComponents(Pack);
+			bDeferDeactivation ? Pack.ReleaseComponents(PendingDeactivations) : Pack.Invalidate();
+			Iterator.RemoveCurrent();
+		}
+	}
+}
+
+UFXSystemComponent* UFXManagerSubsystem::GetVfxSystemComponentByTag(const FActiveEffectPackHandle& Handle,
+	FGameplayTag Tag)
+{
+	return Internal_GetVfxSystemComponent(Handle, [Tag](const FActiveEffect<UFXSystemComponent>& ActiveEffect)
+	{
+		return ActiveEffect.AccessTag == Tag;
+	});
+}
+
+UAudioComponent* UFXManagerSubsystem::GetSfxSystemComponentByTag(const FActiveEffectPackHandle& Handle,
+	FGameplayTag Tag)
+{
+	return Internal_FindSfxSystemComponent(Handle, [Tag](const FActiveEffect<UAudioComponent>& ActiveEffect)
+	{
+		return ActiveEffect.AccessTag == Tag;
+	});
+}
+
+int32 UFXManagerSubsystem::GetCulledVFXCount(const FActiveEffectPackHandle& Handle) const
+{
+	return Handle.GetNumCulledVFX();
+}
+
+void UFXManagerSubsystem::GetSkippedSoundCounts(const FActiveEffectPackHandle& Handle, int32& NumInaudible,
+	int32& NumOverBudget) const
+{
+	NumInaudible = Handle.GetNumInaudibleSounds();
+	NumOverBudget = Handle.GetNumOverBudgetSounds();
+}
+
+UFXSystemComponent* UFXManagerSubsystem::SpawnVFXDataAtLocation(const FVFXData VFXData, const AActor* SourceActor, const FTransform& Transform,
+	bool* bOutCulled, bool bKeepAlive)
+{
+	if(bOutCulled)
+	{
+		*bOutCulled = false;
+	}
+
+	UFXSystemAsset* Asset = VFXData.ParticleSystem;
+	if(!Asset)
+	{
+		return nullptr;
+	}
+
+	const FVector Location = GetVFXSpawnLocation(VFXData, nullptr, Transform);
+	if(VFXData.bEnableViewCulling && !IsVFXRelevant(VFXData, SourceActor, Location))
+	{
+		INC_DWORD_STAT(STAT_FXManager_NumCulledVFX);
+
+		if(bOutCulled)
+		{
+			*bOutCulled = true;
+		}
+
+		return nullptr;
+	}
+
+	const FRotator Rotation = FRotator(Transform.GetRotation() + VFXData.AttachmentData.RelativeTransform.GetRotation());
+	const FVector Scale = Transform.GetScale3D() * VFXData.AttachmentData.RelativeTransform.GetScale3D();
+
+	return SpawnBackend->SpawnVFXAtLocation(SourceActor, Asset, Location, Rotation, Scale, !bKeepAlive);
+}
+
+UAudioComponent* UFXManagerSubsystem::SpawnSFXDataAtLocation(const FSFXData SFXData, const AActor* SourceActor, const FTransform& Transform,
+	ESoundSpawnResult* OutResult, bool bKeepAlive)
+{
+	ESoundSpawnResult Result = ESoundSpawnResult::Failed;
+	UAudioComponent* Component = nullptr;
+	UAudioComponent* SoundToEvict = nullptr;
+
+	USoundBase* Asset = SFXData.Sound;
+	if(Asset)
+	{
+		const FVector Location = Transform.GetLocation() + SFXData.AttachmentData.RelativeTransform.GetLocation();
+		Result = CanSpawnSound(SFXData, SourceActor, Location, SoundToEvict);
+
+		if(Result == ESoundSpawnResult::Spawned)
+		{
+			if(SFXData.AudioType == EAudioType::TwoDimensional)
+			{
+				Component = SpawnBackend->SpawnSound2D(SourceActor, Asset, !bKeepAlive);
+			}
+			else if(SFXData.AudioType == EAudioType::ThreeDimensional)
+			{
+				const FRotator Rotation = FRotator(Transform.GetRotation() + SFXData.AttachmentData.RelativeTransform.GetRotation());
+				Component = SpawnBackend->SpawnSoundAtLocation(SourceActor, Asset, Location, Rotation, !bKeepAlive);
+			}
+
+			if(Component)
+			{
+				TrackSoundConcurrency(SFXData, Component, SoundToEvict);
+			}
+			else
+			{
+				Result = ESoundSpawnResult::Failed;
+			}
+		}
+	}
+
+	if(OutResult)
+	{
+		*OutResult = Result;
+	}
+
+	return Component;
+}
+
+UFXSystemComponent* UFXManagerSubsystem::SpawnVFXDataAtComponent(const FVFXData VFXData, const AActor* SourceActor,
+	USceneComponent* AttachComponent, bool* bOutCulled, bool bKeepAlive)
+{
+	if(bOutCulled)
+	{
+		*bOutCulled = false;
+	}
+
+	UFXSystemAsset* Asset = VFXData.ParticleSystem;
+	if (!Asset)
+	{
+		return nullptr;
+	}
+
+	/* If our attach type is at socket location, return our effect at location instead of trying to attach */
+	if(VFXData.AttachmentData.AttachType == EAttachType::AtSocketLocation)
+	{
+		return SpawnVFXDataAtLocation(VFXData, SourceActor, AttachComponent->GetSocketTransform(VFXData.AttachmentData.SocketName), bOutCulled, bKeepAlive);
+	}
+
+	/* Checked first so effects without culling skip the socket lookup */
+	if(VFXData.bEnableViewCulling && !IsVFXRelevant(VFXData, SourceActor, GetVFXSpawnLocation(VFXData, AttachComponent, FTransform::Identity)))
+	{
+		INC_DWORD_STAT(STAT_FXManager_NumCulledVFX);
+
+		if(bOutCulled)
+		{
+			*bOutCulled = true;
+		}
+
+		return nullptr;
+	}
+
+	const FTransform RelativeTransform = VFXData.GetRelativeTransform();
+	const EAttachLocation::Type AttachRule = GetAttachLocationType(VFXData.AttachmentData.AttachmentRule);
+
+	return SpawnBackend->SpawnVFXAttached(Asset, AttachComponent, VFXData.AttachmentData.SocketName, RelativeTransform.GetLocation(),
+		FRotator(RelativeTransform.GetRotation()), RelativeTransform.GetScale3D(), AttachRule, !bKeepAlive);
+}
+
+UAudioComponent* UFXManagerSubsystem::SpawnSFXDataAtComponent(const FSFXData SFXData, const AActor* SourceActor,
+	USceneComponent* AttachComponent, ESoundSpawnResult* OutResult, bool bKeepAlive)
+{
+	if(OutResult)
+	{
+		*OutResult = ESoundSpawnResult::Failed;
+	}
+
+	USoundBase* Asset = SFXData.Sound;
+	if (!Asset)
+	{
+		return nullptr;
+	}
+
+	/* If our attach type is at socket location or we are playing a generic two dimensional sound, play it at location instead of attached */
+	if (SFXData.AttachmentData.AttachType == EAttachType::AtSocketLocation || SFXData.AudioType == EAudioType::TwoDimensional)
+	{
+		return SpawnSFXDataAtLocation(SFXData, SourceActor, AttachComponent->GetSocketTransform(SFXData.AttachmentData.SocketName), OutResult, bKeepAlive);
+	}
+
+	const FTransform RelativeTransform = SFXData.GetRelativeTransform();
+	const EAttachLocation::Type AttachRule = GetAttachLocationType(SFXData.AttachmentData.AttachmentRule);
+
+	/* Only the audibility check reads the location, so we skip the socket lookup when it isn't needed */
+	const FVector Location = SFXData.ShouldCheckAudibility()
+		? AttachComponent->GetSocketTransform(SFXData.AttachmentData.SocketName).TransformPosition(RelativeTransform.GetLocation())
+		: FVector::ZeroVector;
+
+	UAudioComponent* SoundToEvict = nullptr;
+	const ESoundSpawnResult Result = CanSpawnSound(SFXData, SourceActor, Location, SoundToEvict);
+	if(OutResult)
+	{
+		*OutResult = Result;
+	}
+
+	if(Result != ESoundSpawnResult::Spawned)
+	{
+		return nullptr;
+	}
+
+	UAudioComponent* Component = SpawnBackend->SpawnSoundAttached(Asset, AttachComponent, SFXData.AttachmentData.SocketName,
+		RelativeTransform.GetLocation(), FRotator(RelativeTransform.GetRotation()), AttachRule, !bKeepAlive);
+
+	if(!Component)
+	{
+		if(OutResult)
+		{
+			*OutResult = ESoundSpawnResult::Failed;
+		}
+
+		return nullptr;
+	}
+
+	TrackSoundConcurrency(SFXData, Component, SoundToEvict);
+	return Component;
+}
+
+bool UFXManagerSubsystem::IsVFXRelevant(const FVFXData& VFXData, const AActor* SourceActor, const FVector& Location)
+{
+	if(!VFXData.bEnableViewCulling || !SourceActor)
+	{
+		return true;
+	}
+
+	/* Without a local view, e.g. before the first camera update, we can't know what is relevant so we always spawn */
+	const TArray<FFXLocalView>& Views = GetLocalViews(SourceActor->GetWorld());
+	if(Views.IsEmpty())
+	{
+		return true;
+	}
+
+	return Views.ContainsByPredicate([&VFXData, &Location](const FFXLocalView& View)
+	{
+		if(VFXData.CullDistance > 0.f && FVector::DistSquared(View.Location, Location) > FMath::Square(VFXData.CullDistance))
+		{
+			return false;
+		}
+
+		return !VFXData.bCullOutsideFrustum || View.Frustum.IntersectSphere(Location, VFXData.CullRadius);
+	});
+}
+
+FVector UFXManagerSubsystem::GetVFXSpawnLocation(const FVFXData& VFXData, const USceneComponent* AttachComponent,
+	const FTransform& Transform)
+{
+	if(!AttachComponent)
+	{
+		return Transform.GetLocation() + VFXData.AttachmentData.RelativeTransform.GetLocation();
+	}
+
+	const FTransform SocketTransform = AttachComponent->GetSocketTransform(VFXData.AttachmentData.SocketName);
+	if(VFXData.AttachmentData.AttachType == EAttachType::AtSocketLocation)
+	{
+		return SocketTransform.GetLocation() + VFXData.AttachmentData.RelativeTransform.GetLocation();
+	}
+
+	return (VFXData.GetRelativeTransform() * SocketTransform).GetLocation();
+}
+
+bool UFXManagerSubsystem::AddPendingCulledVFX(const FActiveEffectPack& ActivePack, const FVFXData& VFXData, AActor* SourceActor,
+	USceneComponent* AttachComponent, const FTransform& Transform, bool bFollow)
+{
+	/* Only active packs live long enough for a late spawn to be added to them */
+	if(ActivePack.ActivationType != EEffectActivationType::Active || VFXData.RelevancyWindow <= 0.f)
+	{
+		return false;
+	}
+
+	PendingCulledVFX.Add(FPendingCulledVFX(ActivePack.Id, VFXData, SourceActor, AttachComponent, Transform, bFollow));
+	return true;
+}
+
+void UFXManagerSubsystem::UpdatePendingCulledVFX(float DeltaTime)
+{
+	for(auto Iterator = PendingCulledVFX.CreateIterator(); Iterator; ++Iterator)
+	{
+		FPendingCulledVFX& Pending = *Iterator;
+		Pending.TimeRemaining -= DeltaTime;
+
+		FActiveEffectPack* Pack = ActiveEffectPacks.FindByPredicate([&Pending](const FActiveEffectPack& ActivePack)
+		{
+			return ActivePack.Id == Pending.PackId;
+		});
+
+		FFollowingEffectPack* FollowingPack = !Pending.bFollow ? nullptr : FollowingEffectPacks.FindByPredicate(
+			[&Pending](const FFollowingEffectPack& Following)
+		{
+			return Following.Id == Pending.PackId;
+		});
+
+		AActor* SourceActor = Pending.SourceActor.Get();
+		USceneComponent* AttachComponent = Pending.AttachComponent.Get();
+		const bool bWasAttached = !Pending.AttachComponent.IsExplicitlyNull();
+
+		if(!Pack || !SourceActor || (bWasAttached && !AttachComponent) || (Pending.bFollow && !FollowingPack))
+		{
+			if(FollowingPack)
+			{
+				--FollowingPack->NumPendingEffects;
+			}
+
+			Iterator.RemoveCurrentSwap();
+			continue;
+		}
+
+		/* Following effects spawn unattached at their socket, the following pack keeps them there afterwards */
+		USceneComponent* SpawnComponent = Pending.bFollow ? nullptr : AttachComponent;
+		const FTransform SpawnTransform = Pending.bFollow
+			? AttachComponent->GetSocketTransform(Pending.VFXData.AttachmentData.SocketName)
+			: Pending.Transform;
+
+		/* Checked before spawning so an effect that stays culled is only counted by our stats when it was first played */
+		if(Pending.VFXData.bEnableViewCulling
+			&& !IsVFXRelevant(Pending.VFXData, SourceActor, GetVFXSpawnLocation(Pending.VFXData, SpawnComponent, SpawnTransform)))
+		{
+			if(Pending.TimeRemaining <= 0.f)
+			{
+				if(FollowingPack)
+				{
+					--FollowingPack->NumPendingEffects;
+				}
+
+				Iterator.RemoveCurrentSwap();
+			}
+
+			continue;
+		}
+
+		UFXSystemComponent* Vfx = SpawnComponent
+			? SpawnVFXDataAtComponent(Pending.VFXData, SourceActor, SpawnComponent, nullptr, Pack->bKeepAlive)
+			: SpawnVFXDataAtLocation(Pending.VFXData, SourceActor, SpawnTransform, nullptr, Pack->bKeepAlive);
+
+		Pack->AddActiveVFX(Vfx, Pending.VFXData.AccessTag);
+		Pack->AddSocketBinding(Vfx, Pending.VFXData);
+		--Pack->NumCulledVFX;
+
+		if(FollowingPack)
+		{
+			FollowingPack->AddEffect(Vfx, Pending.VFXData);
+			--FollowingPack->NumPendingEffects;
+		}
+
+		/* The pack may have been throttled while the effect waited, so it starts at the pack's current significance */
+		FActiveEffect<UFXSystemComponent>& Effect = Pack->ActiveFXSystemComponents.Last();
+		FActiveEffectPack::HoldFromPool(Effect);
+		ApplyVFXSignificance(Effect, EEffectSignificance::Significant, Pack->Significance);
+
+		Iterator.RemoveCurrentSwap();
+	}
+
+	SET_DWORD_STAT(STAT_FXManager_NumPendingCulledVFX, PendingCulledVFX.Num());
+}
+
+const TArray<FFXLocalView>& UFXManagerSubsystem::GetLocalViews(const UWorld* World)
+{
+	if(CachedLocalViewsFrame != GFrameCounter)
+	{
+		CachedLocalViews.Reset();
+		CachedLocalViewsFrame = GFrameCounter;
+	}
+
+	if(const TArray<FFXLocalView>* Views = CachedLocalViews.Find(World))
+	{
+		return *Views;
+	}
+
+	TArray<FFXLocalView>& Views = CachedLocalViews.Add(World);
+	if(!World)
+	{
+		return Views;
+	}
+
+	/* The camera cache holds the view each local player rendered with last frame */
+	for(FConstPlayerControllerIterator Iterator = World->GetPlayerControllerIterator(); Iterator; ++Iterator)
+	{
+		const APlayerController* Controller = Iterator->Get();
+		if(!Controller || !Controller->IsLocalController() || !Controller->PlayerCameraManager)
+		{
+			continue;
+		}
+
+		const FMinimalViewInfo& ViewInfo = Controller->PlayerCameraManager->GetCameraCacheView();
+
+		FMatrix ViewMatrix;
+		FMatrix ProjectionMatrix;
+		FMatrix ViewProjectionMatrix;
+		UGameplayStatics::GetViewProjectionMatrix(ViewInfo, ViewMatrix, ProjectionMatrix, ViewProjectionMatrix);
+
+		FFXLocalView& View = Views.AddDefaulted_GetRef();
+		View.Location = ViewInfo.Location;
+		GetViewFrustumBounds(View.Frustum, ViewProjectionMatrix, false);
+	}
+
+	return Views;
+}
+
+ESoundSpawnResult UFXManagerSubsystem::CanSpawnSound(const FSFXData& SFXData, const AActor* SourceActor, const FVector& Location,
+	UAudioComponent*& OutSoundToEvict)
+{
+	OutSoundToEvict = nullptr;
+
+	if(SFXData.ShouldCheckAudibility())
+	{
+		const UWorld* World = SourceActor ? SourceActor->GetWorld() : nullptr;
+		const FAudioDevice* AudioDevice = World ? World->GetAudioDeviceRaw() : nullptr;
+		if(AudioDevice && !AudioDevice->LocationIsAudible(Location, SFXData.Sound->GetMaxDistance()))
+		{
+			return ESoundSpawnResult::Inaudible;
+		}
+	}
+
+	if(!SFXData.HasConcurrencyLimit())
+	{
+		return ESoundSpawnResult::Spawned;
+	}
+
+	TArray<FSoundConcurrencyEntry>* Group = SoundConcurrencyGroups.Find(SFXData.ConcurrencyGroup);
+	if(!Group)
+	{
+		return ESoundSpawnResult::Spawned;
+	}
+
+	// Finished or destroyed sounds no longer count against our budget
+	Group->RemoveAllSwap([](const FSoundConcurrencyEntry& Entry) { return !Entry.IsPlaying(); });
+	if(Group->Num() < SFXData.MaxConcurrency)
+	{
+		return ESoundSpawnResult::Spawned;
+	}
+
+	// Our group is full, replace the lowest priority sound if we outrank it
+	int LowestIndex = INDEX_NONE;
+	for(int i = 0; i < Group->Num(); ++i)
+	{
+		if(LowestIndex == INDEX_NONE || (*Group)[i].Priority < (*Group)[LowestIndex].Priority)
+		{
+			LowestIndex = i;
+		}
+	}
+
+	if(LowestIndex == INDEX_NONE || (*Group)[LowestIndex].Priority >= SFXData.Priority)
+	{
+		return ESoundSpawnResult::OverBudget;
+	}
+
+	/* The lowest priority sound is only stopped once our replacement actually spawned */
+	OutSoundToEvict = (*Group)[LowestIndex].Component.Get();
+	return ESoundSpawnResult::Spawned;
+}
+
+void UFXManagerSubsystem::TrackSoundConcurrency(const FSFXData& SFXData, UAudioComponent* Component, UAudioComponent* SoundToEvict)
+{
+	if(!SFXData.HasConcurrencyLimit() || !Component)
+	{
+		return;
+	}
+
+	TArray<FSoundConcurrencyEntry>& Group = SoundConcurrencyGroups.FindOrAdd(SFXData.ConcurrencyGroup);
+
+	if(SoundToEvict)
+	{
+		Group.RemoveAllSwap([SoundToEvict](const FSoundConcurrencyEntry& Entry) { return Entry.Component == SoundToEvict; });
+		SoundToEvict->Stop();
+	}
+
+	Group.Add(FSoundConcurrencyEntry(Component, SFXData.Priority));
+}
+
+
+FActiveEffectPack& UFXManagerSubsystem::GetActivePack(const FActiveEffectPackHandle& Handle)
+{
+	FActiveEffectPack TempPack;
+	if(!Handle.IsValid())
+	{
+		return TempPack;
+	}
+	
+	/* Get our active or instant pack array based on the activation data from our handle */
+	TArray<FActiveEffectPack>& Array = Handle.GetPackType() == EEffectActivationType::Active ? ActiveEffectPacks : InstantEffectPacks;
+	for (auto Iterator = Array.CreateConstIterator(); Iterator; ++Iterator)
+	{
+		FActiveEffectPack& Pack = Array[Iterator.GetIndex()];
+		if (Pack.Id == Handle.GetId())
+		{
+			return Pack;
+		}
+	}
+	
+	return TempPack;
+}
+
+void UFXManagerSubsystem::AddActivePack(FActiveEffectPack& ActivePack)
+{
+	ActivePack.HoldPooledVFX();
+	ActiveEffectPacks.Add(ActivePack);
+}
+
+void UFXManagerSubsystem::AddInstantPack(const UObject* WorldContextObject, const FActiveEffectPack& ActivePack)
+{
+	InstantEffectPacks.Add(ActivePack);
+	if(!WorldContextObject->GetWorld()->GetTimerManager().IsTimerActive(InstantPackTimerHandle))
+	{
+		InstantPackTimerHandle = WorldContextObject->GetWorld()->GetTimerManager().SetTimerForNextTick(this, &UFXManagerSubsystem::ClearInstantPacks);
+	}
+}
+
+void UFXManagerSubsystem::ClearInstantPacks()
+{
+	InstantEffectPacks.Empty();
+}
+
+int UFXManagerSubsystem::GenerateNewActivePackId()
+{
+	return Internal_NextId++;
+}
+
+const FEffectPack* UFXManagerSubsystem::FindRegisteredEffectPack(const FGameplayTag& PackId) const
+{
+	const FEffectPack* EffectPack = RegisteredEffectPacks.Find(PackId);
+	if(!EffectPack)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("No Effect Pack is registered for %s."), *PackId.ToString())
+	}
+
+	return EffectPack;
+}
+
+void UFXManagerSubsystem::UpdateFollowingPacks(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_FXManager_UpdateFollowingPacks);
+
+	for(auto Iterator = FollowingEffectPacks.CreateIterator(); Iterator; ++Iterator)
+	{
+		FFollowingEffectPack& Pack = *Iterator;
+		if(Pack.IsFinished())
+		{
+			Iterator.RemoveCurrentSwap();
+			continue;
+		}
+
+		Pack.TimeSinceUpdate += DeltaTime;
+
+		if(Pack.Settings.ReducedRateDistance > 0.f && Pack.TimeSinceUpdate < Pack.Settings.ReducedRateInterval)
+		{
+			const USceneComponent* FollowComponent = Pack.FollowComponent.Get();
+			const TArray<FFXLocalView>& Views = GetLocalViews(FollowComponent->GetWorld());
+
+			const FVector PackLocation = FollowComponent->GetComponentLocation();
+			const float DistanceSquared = FMath::Square(Pack.Settings.ReducedRateDistance);
+			const bool bIsNearView = Views.IsEmpty() || Views.ContainsByPredicate([&](const FFXLocalView& View)
+			{
+				return FVector::DistSquared(View.Location, PackLocation) <= DistanceSquared;
+			});
+
+			if(!bIsNearView)
+			{
+				continue;
+			}
+		}
+
+		Pack.UpdateTransforms();
+	}
+
+	SET_DWORD_STAT(STAT_FXManager_NumFollowingPacks, FollowingEffectPacks.Num());
+}
+
+void UFXManagerSubsystem::UpdatePackSignificance()
+{
+	if(ActiveEffectPacks.IsEmpty())
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_FXManager_UpdatePackSignificance);
+
+	int NumThrottledPacks = 0;
+
+	for(auto Iterator = ActiveEffectPacks.CreateIterator(); Iterator; ++Iterator)
+	{
+		FActiveEffectPack& Pack = *Iterator;
+
+		/* Kept alive packs never finish on their own, so once their attach component is gone they can't be restarted
+		 * and are released here instead of holding their components forever */
+		if(Pack.bKeepAlive && !Pack.AttachComponent.IsValid())
+		{
+			SetPackSignificance(Pack, EEffectSignificance::Significant);
+			ReleaseKeptAliveComponents(Pack);
+			Pack.Invalidate();
+			Iterator.RemoveCurrent();
+			continue;
+		}
+
+		/* Done even while significance is disabled so held pooled components still go back to their pool once they finish */
+		RemoveFinishedEffects(Pack);
+
+		/* Disabling significance restores packs that were throttled before it was turned off */
+		const EEffectSignificance NewSignificance = GSignificanceEnabled
+			? ScorePackSignificance(Pack)
+			: EEffectSignificance::Significant;
+
+		SetPackSignificance(Pack, NewSignificance);
+		NumThrottledPacks += NewSignificance != EEffectSignificance::Significant ? 1 : 0;
+	}
+
+	SET_DWORD_STAT(STAT_FXManager_NumThrottledPacks, NumThrottledPacks);
+}
+
+EEffectSignificance UFXManagerSubsystem::ScorePackSignificance(const FActiveEffectPack& Pack)
+{
+	/* Packs whose source died or that have nothing left to place have nothing to score, so they run unthrottled */
+	FVector PackLocation;
+	const AActor* SourceActor = Pack.SourceActor.Get();
+	if(!SourceActor || !Pack.GetLocation(PackLocation))
+	{
+		return EEffectSignificance::Significant;
+	}
+
+	/* Without a local view, e.g. on a dedicated server, there is nothing to score against */
+	const TArray<FFXLocalView>& Views = GetLocalViews(SourceActor->GetWorld());
+	if(Views.IsEmpty())
+	{
+		return EEffectSignificance::Significant;
+	}
+
+	float NearestDistanceSquared = TNumericLimits<float>::Max();
+	for(const FFXLocalView& View : Views)
+	{
+		NearestDistanceSquared = FMath::Min(NearestDistanceSquared, static_cast<float>(FVector::DistSquared(View.Location, PackLocation)));
+	}
+
+	if(NearestDistanceSquared > FMath::Square(GSignificancePauseDistance))
+	{
+		return EEffectSignificance::Insignificant;
+	}
+
+	if(NearestDistanceSquared > FMath::Square(GSignificanceReducedDistance)
+		|| (Pack.HasVFX() && !Pack.WasRecentlyRendered(GSignificanceUpdateInterval)))
+	{
+		return EEffectSignificance::Reduced;
+	}
+
+	return EEffectSignificance::Significant;
+}
+
+void UFXManagerSubsystem::SetPackSignificance(FActiveEffectPack& Pack, EEffectSignificance NewSignificance)
+{
+	if(Pack.Significance == NewSignificance)
+	{
+		return;
+	}
+
+	for(FActiveEffect<UFXSystemComponent>& Effect : Pack.ActiveFXSystemComponents)
+	{
+		ApplyVFXSignificance(Effect, Pack.Significance, NewSignificance);
+	}
+
+	for(FActiveEffect<UAudioComponent>& Effect : Pack.ActiveSoundComponents)
+	{
+		ApplySoundSignificance(Effect, Pack.Significance, NewSignificance);
+	}
+
+	Pack.Significance = NewSignificance;
+}
+
+void UFXManagerSubsystem::ApplyVFXSignificance(FActiveEffect<UFXSystemComponent>& Effect, EEffectSignificance OldSignificance,
+	EEffectSignificance NewSignificance)
+{
+	UFXSystemComponent* Component = Effect.Object.Get();
+	if(!Component || OldSignificance == NewSignificance)
+	{
+		return;
+	}
+
+	UNiagaraComponent* Niagara = Cast<UNiagaraComponent>(Component);
+
+	if(OldSignificance == EEffectSignificance::Significant)
+	{
+		Effect.OriginalTickInterval = Component->GetComponentTickInterval();
+		Effect.bOriginalTickEnabled = Component->IsComponentTickEnabled();
+		Effect.bOriginalPaused = Niagara && Niagara->IsPaused();
+	}
+
+	const bool bRestore = NewSignificance == EEffectSignificance::Significant;
+	const bool bPause = NewSignificance == EEffectSignificance::Insignificant;
+
+	/* Only Cascade and solo Niagara systems simulate from their component tick, other Niagara systems are batched by the
+	 * Niagara world manager and ignore the interval, so reduced significance leaves them running at full rate */
+	Component->SetComponentTickInterval(bRestore ? Effect.OriginalTickInterval : FMath::Max(Effect.OriginalTickInterval, GSignificanceReducedTickInterval));
+
+	/* Niagara systems can be paused outright, Cascade systems stop ticking instead */
+	if(Niagara)
+	{
+		Niagara->SetPaused(Effect.bOriginalPaused || bPause);
+	}
+	else
+	{
+		Component->SetComponentTickEnabled(Effect.bOriginalTickEnabled && !bPause);
+	}
+}
+
+void UFXManagerSubsystem::ApplySoundSignificance(FActiveEffect<UAudioComponent>& Effect, EEffectSignificance OldSignificance,
+	EEffectSignificance NewSignificance)
+{
+	UAudioComponent* Component = Effect.Object.Get();
+	if(!Component || OldSignificance == NewSignificance)
+	{
+		return;
+	}
+
+	if(OldSignificance == EEffectSignificance::Significant)
+	{
+		Effect.bOriginalPaused = Component->GetPlayState() == EAudioComponentPlayState::Paused;
+	}
+
+	/* Far sounds are paused rather than stopped so they resume where they left off */
+	Component->SetPaused(Effect.bOriginalPaused || NewSignificance == EEffectSignificance::Insignificant);
+}
+
+void UFXManagerSubsystem::RemoveFinishedEffects(FActiveEffectPack& Pack)
+{
+	if(Pack.bKeepAlive)
+	{
+		return;
+	}
+
+	for(int i = Pack.ActiveFXSystemComponents.Num() - 1; i >= 0; --i)
+	{
+		FActiveEffect<UFXSystemComponent>& Effect = Pack.ActiveFXSystemComponents[i];
+		const UFXSystemComponent* Component = Effect.Object.Get();
+		if(Component && Component->IsActive())
+		{
+			continue;
+		}
+
+		/* Pooled components go back with the tick settings they were spawned with */
+		ApplyVFXSignificance(Effect, Pack.Significance, EEffectSignificance::Significant);
+		FActiveEffectPack::ReleaseToPool(Effect);
+		Pack.ActiveFXSystemComponents.RemoveAt(i);
+	}
+
+	Pack.ActiveSoundComponents.RemoveAll([](const FActiveEffect<UAudioComponent>& Effect)
+	{
+		return !Effect.Object.IsValid() || !Effect.Object->IsActive();
+	});
+}
+
+void UFXManagerSubsystem::ReleaseKeptAliveComponents(FActiveEffectPack& Pack)
+{
+	if(!Pack.bKeepAlive)
+	{
+		return;
+	}
+
+	/* Active components destroy themselves once deactivation completes, finished ones would never complete so they go now.
+	 * Unregistered components, such as the null backend's, have no playback left to finish so they go now as well */
+	for(const FActiveEffect<UFXSystemComponent>& Effect : Pack.ActiveFXSystemComponents)
+	{
+		UFXSystemComponent* Component = Effect.Object.Get();
+		if(!Component)
+		{
+			continue;
+		}
+
+		if(!Component->IsActive() || !Component->IsRegistered())
+		{
+			Component->DestroyComponent();
+		}
+		else if(UNiagaraComponent* Niagara = Cast<UNiagaraComponent>(Component))
+		{
+			Niagara->SetAutoDestroy(true);
+		}
+		else if(UParticleSystemComponent* Cascade = Cast<UParticleSystemComponent>(Component))
+		{
+			Cascade->bAutoDestroy = true;
+		}
+	}
+
+	for(const FActiveEffect<UAudioComponent>& Effect : Pack.ActiveSoundComponents)
+	{
+		UAudioComponent* Component = Effect.Object.Get();
+		if(!Component)
+		{
+			continue;
+		}
+
+		if(!Component->IsActive() || !Component->IsRegistered())
+		{
+			Component->DestroyComponent();
+		}
+		else
+		{
+			Component->bAutoDestroy = true;
+		}
+	}
+
+	Pack.SocketBindings.Empty();
+	Pack.KeptAliveSounds.Empty();
+	Pack.bKeepAlive = false;
+}
+
+void UFXManagerSubsystem::ProcessPendingDeactivations()
+{
+	if(PendingDeactivations.IsEmpty())
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_FXManager_ProcessPendingDeactivations);
+
+	/* Always deactivate at least one component so a zero budget still makes progress */
+	const double EndTime = FPlatformTime::Seconds() + GDeactivationBudgetMs / 1000.0;
+	do
+	{
+		PendingDeactivations[PendingDeactivationIndex].Deactivate();
+		++PendingDeactivationIndex;
+	}
+	while(PendingDeactivationIndex < PendingDeactivations.Num() && FPlatformTime::Seconds() < EndTime);
+
+	if(PendingDeactivationIndex >= PendingDeactivations.Num())
+	{
+		PendingDeactivations.Reset();
+		PendingDeactivationIndex = 0;
+	}
+
+	SET_DWORD_STAT(STAT_FXManager_NumPendingDeactivations, PendingDeactivations.Num() - PendingDeactivationIndex);
 }
 
 FGameplayTagContainer UFXManagerSubsystem::GetActorTags(const AActor* Actor) const
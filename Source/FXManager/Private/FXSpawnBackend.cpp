@@ -0,0 +1,188 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FXSpawnBackend.h"
+#include "Components/AudioComponent.h"
+#include "Kismet/GameplayStatics.h"
+#include "NiagaraComponent.h"
+#include "NiagaraFunctionLibrary.h"
+#include "NiagaraSystem.h"
+#include "Particles/ParticleSystem.h"
+
+UFXSystemComponent* FEngineFXSpawnBackend::SpawnVFXAtLocation(const AActor* SourceActor, UFXSystemAsset* Asset,
+	const FVector& Location, const FRotator& Rotation, const FVector& Scale, bool bAutoRelease)
+{
+	/* Location spawns aren't pooled, following and instant packs move them after we hand them out, so they are only
+	 * destroyed once they finish */
+	if(UParticleSystem* Cascade = Cast<UParticleSystem>(Asset))
+	{
+		return UGameplayStatics::SpawnEmitterAtLocation
+		(SourceActor, Cascade, Location, Rotation, Scale, bAutoRelease, EPSCPoolMethod::None);
+	}
+
+	if(UNiagaraSystem* Niagara = Cast<UNiagaraSystem>(Asset))
+	{
+		return Cast<UFXSystemComponent>(UNiagaraFunctionLibrary::SpawnSystemAtLocation(SourceActor, Niagara, 
+			Location, Rotation, Scale, bAutoRelease, true, ENCPoolMethod::None));
+	}
+
+	return nullptr;
+}
+
+UFXSystemComponent* FEngineFXSpawnBackend::SpawnVFXAttached(UFXSystemAsset* Asset, USceneComponent* AttachComponent,
+	FName SocketName, const FVector& Location, const FRotator& Rotation, const FVector& Scale, EAttachLocation::Type AttachRule,
+	bool bAutoRelease)
+{
+	if (UParticleSystem* Cascade = Cast<UParticleSystem>(Asset))
+	{
+		return UGameplayStatics::SpawnEmitterAttached(Cascade, AttachComponent, SocketName, Location,
+			Rotation, Scale, AttachRule, bAutoRelease, bAutoRelease ? EPSCPoolMethod::AutoRelease : EPSCPoolMethod::None, true);
+	}
+
+	if (UNiagaraSystem* Niagara = Cast<UNiagaraSystem>(Asset))
+	{
+		return Cast<UFXSystemComponent>(UNiagaraFunctionLibrary::SpawnSystemAttached(Niagara, AttachComponent, SocketName,
+			Location, Rotation, AttachRule, bAutoRelease, true, bAutoRelease ? ENCPoolMethod::AutoRelease : ENCPoolMethod::None));
+	}
+
+	return nullptr;
+}
+
+UAudioComponent* FEngineFXSpawnBackend::SpawnSound2D(const AActor* SourceActor, USoundBase* Sound, bool bAutoRelease)
+{
+	return UGameplayStatics::SpawnSound2D(SourceActor, Sound, 1.f, 1.f, 0.f, nullptr, false, bAutoRelease);
+}
+
+UAudioComponent* FEngineFXSpawnBackend::SpawnSoundAtLocation(const AActor* SourceActor, USoundBase* Sound,
+	const FVector& Location, const FRotator& Rotation, bool bAutoRelease)
+{
+	return UGameplayStatics::SpawnSoundAtLocation(SourceActor, Sound, Location, Rotation, 1.f, 1.f, 0.f, nullptr, nullptr, bAutoRelease);
+}
+
+UAudioComponent* FEngineFXSpawnBackend::SpawnSoundAttached(USoundBase* Sound, USceneComponent* AttachComponent,
+	FName SocketName, const FVector& Location, const FRotator& Rotation, EAttachLocation::Type AttachRule, bool bAutoRelease)
+{
+	return UGameplayStatics::SpawnSoundAttached(Sound, AttachComponent, SocketName, Location, Rotation, AttachRule, false,
+		1.f, 1.f, 0.f, nullptr, nullptr, bAutoRelease);
+}
+
+void FEngineFXSpawnBackend::RestartVFX(UFXSystemComponent* Component)
+{
+	Component->Activate(true);
+}
+
+void FEngineFXSpawnBackend::RestartSound(UAudioComponent* Component)
+{
+	Component->Play();
+}
+
+FNullFXSpawnBackend::FNullFXSpawnBackend(float InSimulatedLifetime)
+{
+	SimulatedLifetime = InSimulatedLifetime;
+}
+
+template<class T>
+T* FNullFXSpawnBackend::SpawnSimulated(const FVector& Location, bool bAutoRelease)
+{
+	T* Component = NewObject<T>(GetTransientPackage());
+	Component->SetWorldLocation(Location);
+	Component->SetActiveFlag(true);
+
+	SimulatedComponents.Add(Component, {Component, SimulatedLifetime, bAutoRelease});
+	return Component;
+}
+
+UFXSystemComponent* FNullFXSpawnBackend::SpawnVFXAtLocation(const AActor* SourceActor, UFXSystemAsset* Asset,
+	const FVector& Location, const FRotator& Rotation, const FVector& Scale, bool bAutoRelease)
+{
+	++NumVFXSpawned;
+	return SpawnSimulated<UNiagaraComponent>(Location, bAutoRelease);
+}
+
+UFXSystemComponent* FNullFXSpawnBackend::SpawnVFXAttached(UFXSystemAsset* Asset, USceneComponent* AttachComponent,
+	FName SocketName, const FVector& Location, const FRotator& Rotation, const FVector& Scale, EAttachLocation::Type AttachRule,
+	bool bAutoRelease)
+{
+	++NumVFXSpawned;
+	return SpawnSimulated<UNiagaraComponent>(AttachComponent->GetSocketLocation(SocketName), bAutoRelease);
+}
+
+UAudioComponent* FNullFXSpawnBackend::SpawnSound2D(const AActor* SourceActor, USoundBase* Sound, bool bAutoRelease)
+{
+	++NumSoundsSpawned;
+	return SpawnSimulated<UAudioComponent>(FVector::ZeroVector, bAutoRelease);
+}
+
+UAudioComponent* FNullFXSpawnBackend::SpawnSoundAtLocation(const AActor* SourceActor, USoundBase* Sound,
+	const FVector& Location, const FRotator& Rotation, bool bAutoRelease)
+{
+	++NumSoundsSpawned;
+	return SpawnSimulated<UAudioComponent>(Location, bAutoRelease);
+}
+
+UAudioComponent* FNullFXSpawnBackend::SpawnSoundAttached(USoundBase* Sound, USceneComponent* AttachComponent,
+	FName SocketName, const FVector& Location, const FRotator& Rotation, EAttachLocation::Type AttachRule, bool bAutoRelease)
+{
+	++NumSoundsSpawned;
+	return SpawnSimulated<UAudioComponent>(AttachComponent->GetSocketLocation(SocketName), bAutoRelease);
+}
+
+void FNullFXSpawnBackend::RestartVFX(UFXSystemComponent* Component)
+{
+	Restart(Component);
+}
+
+void FNullFXSpawnBackend::RestartSound(UAudioComponent* Component)
+{
+	Restart(Component);
+}
+
+void FNullFXSpawnBackend::Restart(UActorComponent* Component)
+{
+	if(FSimulatedComponent* Simulated = SimulatedComponents.Find(Component))
+	{
+		Component->SetActiveFlag(true);
+		Simulated->TimeRemaining = SimulatedLifetime;
+	}
+}
+
+void FNullFXSpawnBackend::Tick(float DeltaTime)
+{
+	for(auto Iterator = SimulatedComponents.CreateIterator(); Iterator; ++Iterator)
+	{
+		FSimulatedComponent& Simulated = Iterator.Value();
+		UActorComponent* Component = Simulated.Component;
+
+		/* Destroyed components, e.g. released kept alive ones, are left for garbage collection */
+		if(!IsValid(Component))
+		{
+			Iterator.RemoveCurrent();
+			continue;
+		}
+
+		if(Component->IsActive())
+		{
+			Simulated.TimeRemaining -= DeltaTime;
+			if(Simulated.TimeRemaining > 0.f)
+			{
+				continue;
+			}
+
+			Component->SetActiveFlag(false);
+		}
+
+		/* Finished kept alive components wait to be restarted or destroyed by the manager */
+		if(Simulated.bAutoRelease)
+		{
+			Iterator.RemoveCurrent();
+		}
+	}
+}
+
+void FNullFXSpawnBackend::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	for(TPair<UActorComponent*, FSimulatedComponent>& Pair : SimulatedComponents)
+	{
+		Collector.AddReferencedObject(Pair.Value.Component);
+	}
+}
@@ -2,3 +2,64 @@
 
 
 #include "FXTypes.h"
+#include "NiagaraComponent.h"
+
+void FPendingDeactivation::Deactivate() const
+{
+	UActorComponent* Object = Component.Get();
+	if(!Object)
+	{
+		return;
+	}
+
+	Object->Deactivate();
+
+	if(bReleaseToPool)
+	{
+		FActiveEffectPack::ReleaseToPool(Cast<UFXSystemComponent>(Object));
+	}
+}
+
+void FActiveEffectPack::HoldFromPool(FActiveEffect<UFXSystemComponent>& Effect)
+{
+	UFXSystemComponent* Component = Effect.Object.Get();
+	if(UNiagaraComponent* Niagara = Cast<UNiagaraComponent>(Component))
+	{
+		if(Niagara->PoolingMethod == ENCPoolMethod::AutoRelease)
+		{
+			Niagara->PoolingMethod = ENCPoolMethod::ManualRelease;
+			Effect.bHeldFromPool = true;
+		}
+	}
+	else if(UParticleSystemComponent* Cascade = Cast<UParticleSystemComponent>(Component))
+	{
+		if(Cascade->PoolingMethod == EPSCPoolMethod::AutoRelease)
+		{
+			Cascade->PoolingMethod = EPSCPoolMethod::ManualRelease;
+			Effect.bHeldFromPool = true;
+		}
+	}
+}
+
+void FActiveEffectPack::ReleaseToPool(FActiveEffect<UFXSystemComponent>& Effect)
+{
+	if(!Effect.bHeldFromPool)
+	{
+		return;
+	}
+
+	Effect.bHeldFromPool = false;
+	ReleaseToPool(Effect.Object.Get());
+}
+
+void FActiveEffectPack::ReleaseToPool(UFXSystemComponent* Component)
+{
+	if(UNiagaraComponent* Niagara = Cast<UNiagaraComponent>(Component))
+	{
+		Niagara->ReleaseToPool();
+	}
+	else if(UParticleSystemComponent* Cascade = Cast<UParticleSystemComponent>(Component))
+	{
+		Cascade->ReleaseToPool();
+	}
+}
@@ -0,0 +1,80 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FXManagerSubsystem.h"
+#include "FXSpawnBackend.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+#include "NiagaraSystem.h"
+#include "Sound/SoundWave.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFXManagerOneShotBenchmark, "FXManager.Performance.OneShotVsHandle",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+/* Plays the same pack through the handle returning path and the one shot path with the null backend, so the difference
+ * is the manager's own bookkeeping rather than component creation */
+bool FFXManagerOneShotBenchmark::RunTest(const FString& Parameters)
+{
+	constexpr int32 NumPlays = 10000;
+
+	UFXManagerSubsystem* FXManager = UFXManagerSubsystem::GetFXManager();
+	if(!TestNotNull(TEXT("FX Manager"), FXManager))
+	{
+		return false;
+	}
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	AActor* SourceActor = World->SpawnActor<AActor>();
+
+	const TSharedPtr<IFXSpawnBackend> PreviousBackend = FXManager->GetSpawnBackend();
+	const TSharedRef<FNullFXSpawnBackend> NullBackend = MakeShared<FNullFXSpawnBackend>();
+	FXManager->SetSpawnBackend(NullBackend);
+
+	FVFXData VfxData;
+	VfxData.ParticleSystem = NewObject<UNiagaraSystem>(GetTransientPackage());
+
+	FSFXData SfxData;
+	SfxData.Sound = NewObject<USoundWave>(GetTransientPackage());
+
+	FEffectPack EffectPack;
+	EffectPack.VFXData.Add(VfxData);
+	EffectPack.SFXData.Add(SfxData);
+
+	const double HandleStartTime = FPlatformTime::Seconds();
+	for(int32 i = 0; i < NumPlays; ++i)
+	{
+		FXManager->PlayEffectAtLocation(SourceActor, nullptr, EffectPack, EEffectActivationType::Instant, FTransform::Identity);
+	}
+	const double HandleMs = (FPlatformTime::Seconds() - HandleStartTime) * 1000.0;
+
+	/* Instant packs are dropped on the world's next timer tick */
+	World->GetTimerManager().Tick(0.f);
+	TestEqual(TEXT("Handle path spawned every effect"), NullBackend->GetNumVFXSpawned() + NullBackend->GetNumSoundsSpawned(), NumPlays * 2);
+	NullBackend->ResetCounters();
+
+	const double OneShotStartTime = FPlatformTime::Seconds();
+	for(int32 i = 0; i < NumPlays; ++i)
+	{
+		FXManager->PlayEffectOneShot(SourceActor, nullptr, EffectPack, FTransform::Identity);
+	}
+	const double OneShotMs = (FPlatformTime::Seconds() - OneShotStartTime) * 1000.0;
+
+	TestEqual(TEXT("One shot path spawned every effect"), NullBackend->GetNumVFXSpawned() + NullBackend->GetNumSoundsSpawned(), NumPlays * 2);
+
+	AddInfo(FString::Printf(TEXT("%d plays with the null backend: handle path %.3f ms (%.3f us per play), one shot path %.3f ms (%.3f us per play), %.3f ms saved"),
+		NumPlays, HandleMs, HandleMs * 1000.0 / NumPlays, OneShotMs, OneShotMs * 1000.0 / NumPlays, HandleMs - OneShotMs));
+
+	FXManager->SetSpawnBackend(PreviousBackend);
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,26 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "FXTypes.h"
+#include "EffectPackAsset.generated.h"
+
+/**
+ * Data asset holding an effect pack that can be registered with the FX Manager and played by id
+ */
+UCLASS(BlueprintType)
+class FXMANAGER_API UEffectPackAsset : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+public:
+
+	/* Id the effect pack is registered under */
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, meta = (Categories = "Effect"))
+	FGameplayTag PackId;
+
+	UPROPERTY(BlueprintReadOnly, EditAnywhere)
+	FEffectPack EffectPack;
+};
@@ -4,14 +4,18 @@
 
 #include "CoreMinimal.h"
 #include "FXTypes.h"
+#include "Tickable.h"
 #include "UObject/NoExportTypes.h"
 #include "FXManagerSubsystem.generated.h"
 
+class IFXSpawnBackend;
+class UEffectPackAsset;
+
 /**
  * 
  */
 UCLASS()
-class FXMANAGER_API UFXManagerSubsystem : public UEngineSubsystem
+class FXMANAGER_API UFXManagerSubsystem : public UEngineSubsystem, public FTickableGameObject
 {
 	GENERATED_BODY()
 
@@ -27,6 +31,19 @@ public:
 
 	// End Subsystem Overrides
 
+	// Begin Tickable Overrides
+public:
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual ETickableTickType GetTickableTickType() const override;
+
+	virtual bool IsTickable() const override;
+
+	virtual TStatId GetStatId() const override;
+
+	// End Tickable Overrides
+
 private:
 
 	/* What our next Id should be for any active pack */
@@ -40,6 +57,36 @@ private:
 
 	FTimerHandle InstantPackTimerHandle;
 
+	/* Packs whose effects are moved to their followed component during our tick */
+	TArray<FFollowingEffectPack> FollowingEffectPacks;
+
+	/* Components of stopped packs waiting to be deactivated within our per tick budget */
+	TArray<FPendingDeactivation> PendingDeactivations;
+
+	/* Index of the next pending deactivation, the array is reset once every component has been processed */
+	int PendingDeactivationIndex = 0;
+
+	/* Sounds currently playing within each concurrency group, used to enforce voice budgets before spawning */
+	TMap<FName, TArray<FSoundConcurrencyEntry>> SoundConcurrencyGroups;
+
+	/* Validated effect packs that can be played by id without passing the pack on every call */
+	UPROPERTY()
+	TMap<FGameplayTag, FEffectPack> RegisteredEffectPacks;
+
+	/* Culled looping effects waiting to become relevant so they can spawn into their active pack */
+	TArray<FPendingCulledVFX> PendingCulledVFX;
+
+	/* Local views gathered per world for culling, following and significance, reset every frame */
+	TMap<const UWorld*, TArray<FFXLocalView>> CachedLocalViews;
+
+	uint64 CachedLocalViewsFrame = 0;
+
+	/* Seconds since active packs were last scored by significance */
+	float TimeSinceSignificanceUpdate = 0.f;
+
+	/* Creates the components for every effect we spawn */
+	TSharedPtr<IFXSpawnBackend> SpawnBackend;
+
 	/* Maps attachment rules to attach location types */
 	static const TMap<EAttachmentRule, EAttachLocation::Type> AttachmentMap;
 
@@ -48,21 +95,78 @@ public:
 	/* Returns a pointer to our instanced FX manager subsystem, nullptr if the global engine pointer is invalid */
 	static UFXManagerSubsystem* GetFXManager();
 
+	/* Replaces the backend used to create effect components, passing nullptr restores the engine backend */
+	void SetSpawnBackend(TSharedPtr<IFXSpawnBackend> InSpawnBackend);
+
+	TSharedPtr<IFXSpawnBackend> GetSpawnBackend() const { return SpawnBackend; }
+
 	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "FX Manager")
 	FActiveEffectPackHandle PlayEffectAtLocation(AActor* SourceActor, AActor* TargetActor,
 		const FEffectPack& EffectPack, EEffectActivationType ActivationType = EEffectActivationType::Instant,
 		FTransform Transform = FTransform());
 
+	/* Plays an effect pack on a component, kept alive active packs hold on to their components so they can be restarted with RestartPack */
 	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "FX Manager")
 	FActiveEffectPackHandle PlayEffectAttached(AActor* SourceActor, AActor* TargetActor,
 		USceneComponent* AttachComponent, const FEffectPack& EffectPack,
-		EEffectActivationType ActivationType = EEffectActivationType::Instant);
+		EEffectActivationType ActivationType = EEffectActivationType::Instant, bool bKeepAlive = false);
+
+	/* Spawns an effect pack at the sockets of a component and keeps it there from our tick, without attaching to the component */
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "FX Manager", meta = (AutoCreateRefTerm = "FollowSettings"))
+	FActiveEffectPackHandle PlayEffectFollowing(AActor* SourceActor, AActor* TargetActor, USceneComponent* FollowComponent,
+		const FEffectPack& EffectPack, EEffectActivationType ActivationType, const FFollowSettings& FollowSettings);
+
+	/* Plays an effect pack at a location without creating an active pack or handle, use when the spawned effects never need to be accessed */
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "FX Manager")
+	void PlayEffectOneShot(AActor* SourceActor, AActor* TargetActor, const FEffectPack& EffectPack,
+		FTransform Transform = FTransform());
+
+	/* Plays an effect pack on a component without creating an active pack or handle, use when the spawned effects never need to be accessed */
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "FX Manager")
+	void PlayEffectOneShotAttached(AActor* SourceActor, AActor* TargetActor, USceneComponent* AttachComponent,
+		const FEffectPack& EffectPack);
+
+	/* Validates and stores an effect pack so it can be played by id, replacing any pack already registered for the id */
+	UFUNCTION(BlueprintCallable, Category = "FX Manager|Registry")
+	bool RegisterEffectPack(FGameplayTag PackId, const FEffectPack& EffectPack);
+
+	/* Registers the effect pack of a data asset using the asset's pack id */
+	UFUNCTION(BlueprintCallable, Category = "FX Manager|Registry")
+	bool RegisterEffectPackAsset(const UEffectPackAsset* Asset);
+
+	UFUNCTION(BlueprintCallable, Category = "FX Manager|Registry")
+	void UnregisterEffectPack(FGameplayTag PackId);
+
+	UFUNCTION(BlueprintPure, Category = "FX Manager|Registry")
+	bool IsEffectPackRegistered(FGameplayTag PackId) const;
+
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "FX Manager|Registry")
+	FActiveEffectPackHandle PlayEffectById(AActor* SourceActor, AActor* TargetActor, FGameplayTag PackId,
+		EEffectActivationType ActivationType = EEffectActivationType::Instant, FTransform Transform = FTransform());
+
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "FX Manager|Registry")
+	FActiveEffectPackHandle PlayEffectAttachedById(AActor* SourceActor, AActor* TargetActor, USceneComponent* AttachComponent,
+		FGameplayTag PackId, EEffectActivationType ActivationType = EEffectActivationType::Instant, bool bKeepAlive = false);
+
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "FX Manager|Registry")
+	void PlayEffectOneShotById(AActor* SourceActor, AActor* TargetActor, FGameplayTag PackId, FTransform Transform = FTransform());
+
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "FX Manager|Registry")
+	void PlayEffectOneShotAttachedById(AActor* SourceActor, AActor* TargetActor, USceneComponent* AttachComponent, FGameplayTag PackId);
+
+	/* Reactivates the components of a kept alive pack in place, returns false if the handle isn't a kept alive active pack.
+	 * Sounds are checked against audibility and concurrency budgets again, culled effects that never spawned are not retried.
+	 * Packs whose attach component was destroyed are released on our next significance update */
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "FX Manager")
+	bool RestartPack(const FActiveEffectPackHandle& Handle);
 
 	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "FX Manager")
 	void StopActivePack(const FActiveEffectPackHandle& Handle);
 
+	/* Stops every pack in the passed in handles, when deferred the handles are invalidated immediately while
+	 * component deactivation is spread across ticks within FXManager.DeactivationBudgetMs */
 	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "FX MAnager")
-	void StopActivePacks(const TArray<FActiveEffectPackHandle>& Handles);
+	void StopActivePacks(const TArray<FActiveEffectPackHandle>& Handles, bool bDeferDeactivation = false);
 
 	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "FX Manager")
 	UFXSystemComponent* GetVfxSystemComponentByTag(const FActiveEffectPackHandle& Handle, FGameplayTag Tag);
@@ -70,18 +174,75 @@ public:
 	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "FX Manager")
 	UAudioComponent* GetSfxSystemComponentByTag(const FActiveEffectPackHandle& Handle, FGameplayTag Tag);
 
+	/* Returns how many sounds were skipped when the handle's pack was played, split by the reason they were skipped */
+	UFUNCTION(BlueprintPure, Category = "FX Manager")
+	void GetSkippedSoundCounts(const FActiveEffectPackHandle& Handle, int32& NumInaudible, int32& NumOverBudget) const;
+
+	/* Returns how many visual effects were culled by view culling when the handle's pack was played */
+	UFUNCTION(BlueprintPure, Category = "FX Manager")
+	int32 GetCulledVFXCount(const FActiveEffectPackHandle& Handle) const;
+
 private:
 
-	UFXSystemComponent* SpawnVFXDataAtLocation(const FVFXData VFXData, const AActor* SourceActor, const FTransform& Transform) const;
+	/* Plays an already validated effect pack, callers are responsible for checking the pack and actors */
+	FActiveEffectPackHandle Internal_PlayEffectAtLocation(AActor* SourceActor, AActor* TargetActor, const FEffectPack& EffectPack,
+		EEffectActivationType ActivationType, const FTransform& Transform);
+
+	FActiveEffectPackHandle Internal_PlayEffectAttached(AActor* SourceActor, AActor* TargetActor, USceneComponent* AttachComponent,
+		const FEffectPack& EffectPack, EEffectActivationType ActivationType, bool bKeepAlive);
+
+	FActiveEffectPackHandle Internal_PlayEffectFollowing(AActor* SourceActor, AActor* TargetActor, USceneComponent* FollowComponent,
+		const FEffectPack& EffectPack, EEffectActivationType ActivationType, const FFollowSettings& FollowSettings);
+
+	void Internal_PlayEffectOneShot(AActor* SourceActor, AActor* TargetActor, const FEffectPack& EffectPack, const FTransform& Transform);
+
+	void Internal_PlayEffectOneShotAttached(AActor* SourceActor, AActor* TargetActor, USceneComponent* AttachComponent,
+		const FEffectPack& EffectPack);
+
+	/* Returns the registered pack for an id, nullptr and a warning if nothing is registered */
+	const FEffectPack* FindRegisteredEffectPack(const FGameplayTag& PackId) const;
+
+	UFXSystemComponent* SpawnVFXDataAtLocation(const FVFXData VFXData, const AActor* SourceActor, const FTransform& Transform,
+		bool* bOutCulled = nullptr, bool bKeepAlive = false);
+
+	UAudioComponent* SpawnSFXDataAtLocation(const FSFXData SFXData, const AActor* SourceActor, const FTransform& Transform,
+		ESoundSpawnResult* OutResult = nullptr, bool bKeepAlive = false);
+
+	UFXSystemComponent* SpawnVFXDataAtComponent(const FVFXData VFXData, const AActor* SourceActor, USceneComponent* AttachComponent,
+		bool* bOutCulled = nullptr, bool bKeepAlive = false);
 
-	UAudioComponent* SpawnSFXDataAtLocation(const FSFXData SFXData, const AActor* SourceActor, const FTransform& Transform) const;
+	/* Checks a visual effect's culling settings against the local views from the last frame */
+	bool IsVFXRelevant(const FVFXData& VFXData, const AActor* SourceActor, const FVector& Location);
 
-	UFXSystemComponent* SpawnVFXDataAtComponent(const FVFXData VFXData, const AActor* SourceActor, USceneComponent* AttachComponent) const;
+	/* Returns where a visual effect spawns, on the attach component if one is passed in, otherwise at the transform */
+	static FVector GetVFXSpawnLocation(const FVFXData& VFXData, const USceneComponent* AttachComponent, const FTransform& Transform);
 
-	UAudioComponent* SpawnSFXDataAtComponent(const FSFXData SFXData, const AActor* SourceActor, USceneComponent* AttachComponent) const;
+	/* Queues a culled effect of an active pack to spawn if it becomes relevant within its relevancy window, returns false if it can't wait */
+	bool AddPendingCulledVFX(const FActiveEffectPack& ActivePack, const FVFXData& VFXData, AActor* SourceActor,
+		USceneComponent* AttachComponent, const FTransform& Transform, bool bFollow = false);
+
+	/* Spawns pending culled effects that became relevant and drops expired or orphaned ones */
+	void UpdatePendingCulledVFX(float DeltaTime);
+
+	/* Returns the local views of a world as of the last frame, gathered once per frame */
+	const TArray<FFXLocalView>& GetLocalViews(const UWorld* World);
+
+	UAudioComponent* SpawnSFXDataAtComponent(const FSFXData SFXData, const AActor* SourceActor, USceneComponent* AttachComponent,
+		ESoundSpawnResult* OutResult = nullptr, bool bKeepAlive = false);
+
+	/* Checks audibility and our concurrency budget before a sound component is created, returns the lower priority sound that
+	 * has to make room in a full group, the location is only read when the sound checks audibility */
+	ESoundSpawnResult CanSpawnSound(const FSFXData& SFXData, const AActor* SourceActor, const FVector& Location,
+		UAudioComponent*& OutSoundToEvict);
+
+	/* Adds a spawned sound to its concurrency group so it counts against the group's budget, stopping the sound it replaces */
+	void TrackSoundConcurrency(const FSFXData& SFXData, UAudioComponent* Component, UAudioComponent* SoundToEvict);
 
 	FActiveEffectPack& GetActivePack(const FActiveEffectPackHandle& Handle);
 
+	/* Adds packs with an active activation, holding their pooled effects until the pack lets go of them */
+	void AddActivePack(FActiveEffectPack& ActivePack);
+
 	/* Adds packs with an instant activation for the next tick so that they can be modified if necessary */
 	void AddInstantPack(const UObject* WorldContextObject, const FActiveEffectPack& ActivePack);
 
@@ -90,6 +251,37 @@ private:
 	/* Increments our internal id counter and returns the next id */
 	int GenerateNewActivePackId();
 
+	/* Moves following packs to their followed components, packs far from every local view update at their reduced rate */
+	void UpdateFollowingPacks(float DeltaTime);
+
+	/* Scores active packs by distance and visibility to the local views and throttles or restores their components,
+	 * finished effects are dropped from every pack whether or not significance is enabled and kept alive packs that lost
+	 * their attach component are released */
+	void UpdatePackSignificance();
+
+	/* Returns the significance of a pack from its distance to the nearest local view and whether it was recently rendered */
+	EEffectSignificance ScorePackSignificance(const FActiveEffectPack& Pack);
+
+	/* Applies tick intervals and pausing for a significance level, no-op if the pack is already at it. Tick intervals only
+	 * throttle Cascade and solo Niagara systems, other Niagara systems are only affected by pausing */
+	static void SetPackSignificance(FActiveEffectPack& Pack, EEffectSignificance NewSignificance);
+
+	/* Throttles a visual effect for a significance level, caching its own tick and pause state when it leaves significant and restoring it on return */
+	static void ApplyVFXSignificance(FActiveEffect<UFXSystemComponent>& Effect, EEffectSignificance OldSignificance,
+		EEffectSignificance NewSignificance);
+
+	static void ApplySoundSignificance(FActiveEffect<UAudioComponent>& Effect, EEffectSignificance OldSignificance,
+		EEffectSignificance NewSignificance);
+
+	/* Drops effects that finished or were destroyed, restoring and returning held components to their pool, kept alive packs keep theirs */
+	static void RemoveFinishedEffects(FActiveEffectPack& Pack);
+
+	/* Lets the components of a kept alive pack destroy themselves once they finish, called before the pack is stopped */
+	static void ReleaseKeptAliveComponents(FActiveEffectPack& Pack);
+
+	/* Deactivates pending components until our time budget for this tick is used up */
+	void ProcessPendingDeactivations();
+
 	/* Returns actor tags from the IGameplayTagInterface, if implemented by the passed in actor */
 	FGameplayTagContainer GetActorTags(const AActor* Actor) const;
 
@@ -107,9 +299,9 @@ private:
 
 		// Try finding an active effect that matches our tag
 		// Return the object within our found active effect if it exists, otherwise a null pointer
-		if(const FActiveEffect<UFXSystemComponent*>* FoundValue = Pack.ActiveFXSystemComponents.FindByPredicate(Pred))
+		if(const FActiveEffect<UFXSystemComponent>* FoundValue = Pack.ActiveFXSystemComponents.FindByPredicate(Pred))
 		{
-			return (*FoundValue).Object;
+			return (*FoundValue).Object.Get();
 		}
 
 		return nullptr;
@@ -127,9 +319,9 @@ private:
 
 		// Try finding an active effect that matches our tag
 		// Return the object within our found active effect if it exists, otherwise a null pointer
-		if(const FActiveEffect<UAudioComponent*>* FoundValue = Pack.ActiveSoundComponents.FindByPredicate(Pred))
+		if(const FActiveEffect<UAudioComponent>* FoundValue = Pack.ActiveSoundComponents.FindByPredicate(Pred))
 		{
-			return (*FoundValue).Object;
+			return (*FoundValue).Object.Get();
 		}
 
 		return nullptr;
@@ -0,0 +1,148 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/GCObject.h"
+#include "Engine/EngineTypes.h"
+
+class UActorComponent;
+class UAudioComponent;
+class UFXSystemAsset;
+class UFXSystemComponent;
+class USceneComponent;
+class USoundBase;
+
+/**
+ * Creates the components for effects played through the FX Manager, letting the manager's bookkeeping be
+ * measured and tested separately from component creation. Components spawned without auto release must stay
+ * alive after they finish so the manager can reactivate them
+ */
+class FXMANAGER_API IFXSpawnBackend
+{
+public:
+
+	virtual ~IFXSpawnBackend() = default;
+
+	virtual UFXSystemComponent* SpawnVFXAtLocation(const AActor* SourceActor, UFXSystemAsset* Asset, const FVector& Location,
+		const FRotator& Rotation, const FVector& Scale, bool bAutoRelease) = 0;
+
+	virtual UFXSystemComponent* SpawnVFXAttached(UFXSystemAsset* Asset, USceneComponent* AttachComponent, FName SocketName,
+		const FVector& Location, const FRotator& Rotation, const FVector& Scale, EAttachLocation::Type AttachRule, bool bAutoRelease) = 0;
+
+	virtual UAudioComponent* SpawnSound2D(const AActor* SourceActor, USoundBase* Sound, bool bAutoRelease) = 0;
+
+	virtual UAudioComponent* SpawnSoundAtLocation(const AActor* SourceActor, USoundBase* Sound, const FVector& Location,
+		const FRotator& Rotation, bool bAutoRelease) = 0;
+
+	virtual UAudioComponent* SpawnSoundAttached(USoundBase* Sound, USceneComponent* AttachComponent, FName SocketName,
+		const FVector& Location, const FRotator& Rotation, EAttachLocation::Type AttachRule, bool bAutoRelease) = 0;
+
+	/* Reactivates a kept alive component this backend spawned */
+	virtual void RestartVFX(UFXSystemComponent* Component) = 0;
+
+	virtual void RestartSound(UAudioComponent* Component) = 0;
+
+	/* Called from the manager's tick while IsTickable returns true, lets backends that simulate their components advance them */
+	virtual void Tick(float DeltaTime) {}
+
+	virtual bool IsTickable() const { return false; }
+};
+
+/* Default backend, spawns Cascade and Niagara systems and sounds through the engine's gameplay libraries */
+class FXMANAGER_API FEngineFXSpawnBackend : public IFXSpawnBackend
+{
+public:
+
+	virtual UFXSystemComponent* SpawnVFXAtLocation(const AActor* SourceActor, UFXSystemAsset* Asset, const FVector& Location,
+		const FRotator& Rotation, const FVector& Scale, bool bAutoRelease) override;
+
+	virtual UFXSystemComponent* SpawnVFXAttached(UFXSystemAsset* Asset, USceneComponent* AttachComponent, FName SocketName,
+		const FVector& Location, const FRotator& Rotation, const FVector& Scale, EAttachLocation::Type AttachRule, bool bAutoRelease) override;
+
+	virtual UAudioComponent* SpawnSound2D(const AActor* SourceActor, USoundBase* Sound, bool bAutoRelease) override;
+
+	virtual UAudioComponent* SpawnSoundAtLocation(const AActor* SourceActor, USoundBase* Sound, const FVector& Location,
+		const FRotator& Rotation, bool bAutoRelease) override;
+
+	virtual UAudioComponent* SpawnSoundAttached(USoundBase* Sound, USceneComponent* AttachComponent, FName SocketName,
+		const FVector& Location, const FRotator& Rotation, EAttachLocation::Type AttachRule, bool bAutoRelease) override;
+
+	virtual void RestartVFX(UFXSystemComponent* Component) override;
+
+	virtual void RestartSound(UAudioComponent* Component) override;
+};
+
+/**
+ * Headless backend for tests and benchmarks, every spawn creates its own component that is never registered with a world,
+ * so handles, tag filtering and lifetime logic run without the cost of simulating or rendering real effects. Components
+ * stay active for a simulated lifetime, after which auto released ones are let go like their engine counterparts
+ */
+class FXMANAGER_API FNullFXSpawnBackend : public IFXSpawnBackend, public FGCObject
+{
+public:
+
+	explicit FNullFXSpawnBackend(float InSimulatedLifetime = 1.f);
+
+	virtual UFXSystemComponent* SpawnVFXAtLocation(const AActor* SourceActor, UFXSystemAsset* Asset, const FVector& Location,
+		const FRotator& Rotation, const FVector& Scale, bool bAutoRelease) override;
+
+	virtual UFXSystemComponent* SpawnVFXAttached(UFXSystemAsset* Asset, USceneComponent* AttachComponent, FName SocketName,
+		const FVector& Location, const FRotator& Rotation, const FVector& Scale, EAttachLocation::Type AttachRule, bool bAutoRelease) override;
+
+	virtual UAudioComponent* SpawnSound2D(const AActor* SourceActor, USoundBase* Sound, bool bAutoRelease) override;
+
+	virtual UAudioComponent* SpawnSoundAtLocation(const AActor* SourceActor, USoundBase* Sound, const FVector& Location,
+		const FRotator& Rotation, bool bAutoRelease) override;
+
+	virtual UAudioComponent* SpawnSoundAttached(USoundBase* Sound, USceneComponent* AttachComponent, FName SocketName,
+		const FVector& Location, const FRotator& Rotation, EAttachLocation::Type AttachRule, bool bAutoRelease) override;
+
+	virtual void RestartVFX(UFXSystemComponent* Component) override;
+
+	virtual void RestartSound(UAudioComponent* Component) override;
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual bool IsTickable() const override { return !SimulatedComponents.IsEmpty(); }
+
+	// Begin FGCObject Overrides
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+
+	virtual FString GetReferencerName() const override { return TEXT("FNullFXSpawnBackend"); }
+	// End FGCObject Overrides
+
+	int GetNumVFXSpawned() const { return NumVFXSpawned; }
+
+	int GetNumSoundsSpawned() const { return NumSoundsSpawned; }
+
+	void ResetCounters() { NumVFXSpawned = 0; NumSoundsSpawned = 0; }
+
+private:
+
+	/* A spawned component and how long it has left to play */
+	struct FSimulatedComponent
+	{
+		TObjectPtr<UActorComponent> Component;
+		float TimeRemaining;
+		bool bAutoRelease;
+	};
+
+	/* Creates an unregistered component of the passed in class at a location and starts its simulated lifetime */
+	template<class T>
+	T* SpawnSimulated(const FVector& Location, bool bAutoRelease);
+
+	/* Reactivates one of our components and restarts its simulated lifetime */
+	void Restart(UActorComponent* Component);
+
+	/* Components we hold on to keyed by themselves so restarts are a lookup, auto released ones are dropped once they finish,
+	 * kept alive ones once they are destroyed */
+	TMap<UActorComponent*, FSimulatedComponent> SimulatedComponents;
+
+	/* Seconds every spawned component stays active */
+	float SimulatedLifetime;
+
+	int NumVFXSpawned = 0;
+
+	int NumSoundsSpawned = 0;
+};
@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "GameplayTagContainer.h"
 #include "Components/AudioComponent.h"
+#include "ConvexVolume.h"
 #include "Particles/ParticleSystem.h"
 #include "Particles/ParticleSystemComponent.h"
 #include "Sound/SoundCue.h"
@@ -28,6 +29,16 @@ enum class EAudioType : uint8
 	ThreeDimensional
 };
 
+/* Outcome of the manager deciding whether a sound effect should spawn a component */
+UENUM(BlueprintType)
+enum class ESoundSpawnResult : uint8
+{
+	Spawned,
+	Failed,
+	Inaudible,
+	OverBudget
+};
+
 USTRUCT(BlueprintType)
 struct FAttachData
 {
@@ -142,11 +153,36 @@ struct FVFXData : public FFXData
 	FVFXData()
 	{
 		ParticleSystem = nullptr;
+		bEnableViewCulling = false;
+		CullDistance = 0.f;
+		bCullOutsideFrustum = true;
+		CullRadius = 100.f;
+		RelevancyWindow = 0.f;
 	}
 
 	UPROPERTY(BlueprintReadWrite, EditAnywhere)
 	UFXSystemAsset* ParticleSystem;
 
+	/* Skips spawning this effect when it is not relevant to any local view */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Culling")
+	bool bEnableViewCulling;
+
+	/* Effects farther than this from every local view are culled, 0 for no distance limit */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Culling", meta = (ClampMin = 0, EditCondition = "bEnableViewCulling"))
+	float CullDistance;
+
+	/* Culls effects whose bounds are outside the frustum of every local view from the last frame */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Culling", meta = (EditCondition = "bEnableViewCulling"))
+	bool bCullOutsideFrustum;
+
+	/* Radius of the bounds tested against the view frustums */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Culling", meta = (ClampMin = 0, EditCondition = "bEnableViewCulling"))
+	float CullRadius;
+
+	/* For looping effects in packs played as Active, seconds a culled effect keeps waiting to become relevant and spawn, 0 to drop it */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Culling", meta = (ClampMin = 0, EditCondition = "bEnableViewCulling"))
+	float RelevancyWindow;
+
 };
 
 USTRUCT(BlueprintType)
@@ -158,6 +194,10 @@ struct FSFXData : public FFXData
 	{
 		Sound = nullptr;
 		AudioType = EAudioType::TwoDimensional;
+		Priority = 1.f;
+		ConcurrencyGroup = NAME_None;
+		MaxConcurrency = 0;
+		bSkipIfInaudible = false;
 	}
 
 	UPROPERTY(BlueprintReadWrite, EditAnywhere)
@@ -165,6 +205,27 @@ struct FSFXData : public FFXData
 
 	UPROPERTY(BlueprintReadWrite, EditAnywhere)
 	TEnumAsByte<EAudioType> AudioType;
+
+	/* When our concurrency group is full, a sound replaces the lowest priority sound in the group if its priority is higher */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Budget")
+	float Priority;
+
+	/* Sounds sharing a group count against the same voice budget, None disables budgeting */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Budget")
+	FName ConcurrencyGroup;
+
+	/* Maximum number of sounds playing at once within our concurrency group, 0 for no limit */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Budget", meta = (ClampMin = 0))
+	int32 MaxConcurrency;
+
+	/* Skips spawning three dimensional sounds when no listener is within the sound's attenuation range */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Budget")
+	bool bSkipIfInaudible;
+
+	bool HasConcurrencyLimit() const { return ConcurrencyGroup != NAME_None && MaxConcurrency > 0; }
+
+	/* Two dimensional sounds have no attenuation, so they are always audible */
+	bool ShouldCheckAudibility() const { return bSkipIfInaudible && AudioType == EAudioType::ThreeDimensional; }
 };
 
 USTRUCT(BlueprintType)
@@ -200,17 +261,30 @@ enum class EEffectActivationType : uint8
 	Active
 };
 
+/* How much an active pack currently matters to the local views, less significant packs are throttled */
+UENUM(BlueprintType)
+enum class EEffectSignificance : uint8
+{
+	Significant,
+	Reduced,
+	Insignificant
+};
+
 USTRUCT(BlueprintType)
 struct FActiveEffectPackHandle
 {
 	GENERATED_BODY()
 
-	FActiveEffectPackHandle(): Id(-1), ActivationType(EEffectActivationType::None) {}
+	FActiveEffectPackHandle(): Id(-1), ActivationType(EEffectActivationType::None), NumInaudibleSounds(0), NumOverBudgetSounds(0), NumCulledVFX(0) {}
 
-	FActiveEffectPackHandle(int InId, EEffectActivationType InActivationType)
+	FActiveEffectPackHandle(int InId, EEffectActivationType InActivationType, int32 InNumInaudibleSounds = 0, int32 InNumOverBudgetSounds = 0,
+		int32 InNumCulledVFX = 0)
 	{
 		Id = InId;
 		ActivationType = InActivationType;
+		NumInaudibleSounds = InNumInaudibleSounds;
+		NumOverBudgetSounds = InNumOverBudgetSounds;
+		NumCulledVFX = InNumCulledVFX;
 	}
 
 	int GetId() const { return Id; }
@@ -219,25 +293,234 @@ struct FActiveEffectPackHandle
 
 	bool IsValid() const { return Id != -1; }
 
+	/* Sounds that were not spawned because no listener could hear them */
+	int32 GetNumInaudibleSounds() const { return NumInaudibleSounds; }
+
+	/* Sounds that were not spawned because their concurrency group was full */
+	int32 GetNumOverBudgetSounds() const { return NumOverBudgetSounds; }
+
+	bool HasSkippedSounds() const { return NumInaudibleSounds > 0 || NumOverBudgetSounds > 0; }
+
+	/* Visual effects that were not spawned because they were not relevant to any local view */
+	int32 GetNumCulledVFX() const { return NumCulledVFX; }
+
+	bool WasCulled() const { return NumCulledVFX > 0; }
+
 private:
 
 	int Id;
 
 	EEffectActivationType ActivationType;
+
+	int32 NumInaudibleSounds;
+
+	int32 NumOverBudgetSounds;
+
+	int32 NumCulledVFX;
 };
 
 template<class T>
 struct FActiveEffect
 {
-	FActiveEffect(T InObject, FGameplayTag InTag)
+	FActiveEffect(T* InObject, FGameplayTag InTag)
 	{
 		Object = InObject;
 		AccessTag = InTag;
+		OriginalTickInterval = 0.f;
+		bOriginalTickEnabled = true;
+		bOriginalPaused = false;
+		bHeldFromPool = false;
 	}
 	
 	FGameplayTag AccessTag;
-	T Object;
-	
+
+	/* Weak as components the manager doesn't keep alive destroy themselves once they finish */
+	TWeakObjectPtr<T> Object;
+
+	/* Tick and pause state from before significance throttled the component, restored once its pack is significant again */
+	float OriginalTickInterval;
+	bool bOriginalTickEnabled;
+	bool bOriginalPaused;
+
+	/* Pooled component switched to manual release so its pool can't reuse it while we reference it */
+	bool bHeldFromPool;
+};
+
+/* Controls how often the manager moves a following effect pack to its followed component */
+USTRUCT(BlueprintType)
+struct FFollowSettings
+{
+	GENERATED_BODY()
+
+	FFollowSettings()
+	{
+		ReducedRateDistance = 0.f;
+		ReducedRateInterval = 0.1f;
+	}
+
+	/* Packs farther than this from every local view update at the reduced rate, 0 always updates every tick */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, meta = (ClampMin = 0))
+	float ReducedRateDistance;
+
+	/* Seconds between updates while the pack is beyond the reduced rate distance */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, meta = (ClampMin = 0))
+	float ReducedRateInterval;
+};
+
+/* A spawned effect component kept at a socket of a followed component */
+struct FFollowingEffect
+{
+	FFollowingEffect(USceneComponent* InComponent, FName InSocketName, const FTransform& InRelativeTransform)
+	{
+		Component = InComponent;
+		SocketName = InSocketName;
+		RelativeTransform = InRelativeTransform;
+	}
+
+	TWeakObjectPtr<USceneComponent> Component;
+	FName SocketName;
+	FTransform RelativeTransform;
+
+	bool IsActive() const { return Component.IsValid() && Component->IsActive(); }
+};
+
+/* Effects of a single pack that the manager moves together with its followed component on tick */
+struct FFollowingEffectPack
+{
+	FFollowingEffectPack(int InId, USceneComponent* InFollowComponent, const FFollowSettings& InSettings)
+	{
+		Id = InId;
+		FollowComponent = InFollowComponent;
+		Settings = InSettings;
+		TimeSinceUpdate = 0.f;
+		NumPendingEffects = 0;
+	}
+
+	/* Id of the active pack our effects belong to, used to hand late spawned culled effects to us */
+	int Id;
+	TWeakObjectPtr<USceneComponent> FollowComponent;
+	FFollowSettings Settings;
+	float TimeSinceUpdate;
+	TArray<FFollowingEffect> Effects;
+
+	/* Culled effects that may still spawn into us within their relevancy window */
+	int32 NumPendingEffects;
+
+	void AddEffect(USceneComponent* Component, const FFXData& Data)
+	{
+		if(Component)
+		{
+			Effects.Add(FFollowingEffect(Component, Data.AttachmentData.SocketName, Data.GetRelativeTransform()));
+		}
+	}
+
+	/* Finished once the followed component is gone or none of our effects are still playing or waiting to spawn */
+	bool IsFinished() const
+	{
+		return !FollowComponent.IsValid()
+			|| (NumPendingEffects == 0 && !Effects.ContainsByPredicate([](const FFollowingEffect& Effect) { return Effect.IsActive(); }));
+	}
+
+	/* Moves every effect to its socket on the followed component */
+	void UpdateTransforms()
+	{
+		USceneComponent* Target = FollowComponent.Get();
+		if(!Target)
+		{
+			return;
+		}
+
+		for(const FFollowingEffect& Effect : Effects)
+		{
+			if(USceneComponent* Component = Effect.Component.Get())
+			{
+				Component->SetWorldTransform(Effect.RelativeTransform * Target->GetSocketTransform(Effect.SocketName));
+			}
+		}
+
+		TimeSinceUpdate = 0.f;
+	}
+};
+
+/* Location and frustum of a local player's view */
+struct FFXLocalView
+{
+	FVector Location;
+	FConvexVolume Frustum;
+};
+
+/* A culled looping effect waiting for its location to become relevant before it spawns into its pack */
+struct FPendingCulledVFX
+{
+	FPendingCulledVFX(int InPackId, const FVFXData& InVFXData, AActor* InSourceActor, USceneComponent* InAttachComponent,
+		const FTransform& InTransform, bool bInFollow)
+	{
+		PackId = InPackId;
+		VFXData = InVFXData;
+		SourceActor = InSourceActor;
+		AttachComponent = InAttachComponent;
+		Transform = InTransform;
+		TimeRemaining = InVFXData.RelevancyWindow;
+		bFollow = bInFollow;
+	}
+
+	int PackId;
+	FVFXData VFXData;
+	TWeakObjectPtr<AActor> SourceActor;
+
+	/* Component the effect spawns on, spawns at our transform instead when not set */
+	TWeakObjectPtr<USceneComponent> AttachComponent;
+	FTransform Transform;
+	float TimeRemaining;
+
+	/* Spawns unattached at its socket on our attach component and joins the following pack with our pack id */
+	bool bFollow;
+};
+
+/* A component of a stopped pack waiting for its deferred deactivation */
+struct FPendingDeactivation
+{
+	FPendingDeactivation(UActorComponent* InComponent, bool bInReleaseToPool)
+	{
+		Component = InComponent;
+		bReleaseToPool = bInReleaseToPool;
+	}
+
+	TWeakObjectPtr<UActorComponent> Component;
+
+	/* Pooled component held by its pack, returned to its pool once deactivated so it can't be reused before then */
+	bool bReleaseToPool;
+
+	void Deactivate() const;
+};
+
+/* A kept alive sound and the data it was played from, so restarting it is checked against our budget like a new spawn */
+struct FKeptAliveSound
+{
+	FKeptAliveSound(UAudioComponent* InComponent, const FSFXData& InSFXData)
+	{
+		Component = InComponent;
+		SFXData = InSFXData;
+	}
+
+	TWeakObjectPtr<UAudioComponent> Component;
+	FSFXData SFXData;
+};
+
+/* A sound the manager spawned within a concurrency group */
+struct FSoundConcurrencyEntry
+{
+	FSoundConcurrencyEntry(UAudioComponent* InComponent, float InPriority)
+	{
+		Component = InComponent;
+		Priority = InPriority;
+	}
+
+	TWeakObjectPtr<UAudioComponent> Component;
+	float Priority;
+
+	/* Checks the active flag rather than the audio device so sounds from a simulated spawn backend count too */
+	bool IsPlaying() const { return Component.IsValid() && Component->IsActive(); }
 };
 
 USTRUCT()
@@ -252,6 +535,11 @@ struct FActiveEffectPack
 		TargetActor = nullptr;
 		AttachComponent = nullptr;
 		ActivationType = EEffectActivationType::None;
+		NumInaudibleSounds = 0;
+		NumOverBudgetSounds = 0;
+		NumCulledVFX = 0;
+		Significance = EEffectSignificance::Significant;
+		bKeepAlive = false;
 	}
 
 	FActiveEffectPack(int InId, AActor* InSourceActor, AActor* InTargetActor, USceneComponent* InAttachComponent, EEffectActivationType InActivationType)
@@ -261,6 +549,11 @@ struct FActiveEffectPack
 		SourceActor = InSourceActor;
 		TargetActor = InTargetActor;
 		AttachComponent = InAttachComponent;
+		NumInaudibleSounds = 0;
+		NumOverBudgetSounds = 0;
+		NumCulledVFX = 0;
+		Significance = EEffectSignificance::Significant;
+		bKeepAlive = false;
 	}
 
 	bool operator==(const FActiveEffectPackHandle& Other) const { return Id == Other.GetId(); }
@@ -271,19 +564,131 @@ struct FActiveEffectPack
 	TWeakObjectPtr<AActor> SourceActor;
 	TWeakObjectPtr<AActor> TargetActor;
 	TWeakObjectPtr<USceneComponent> AttachComponent;
-	TArray<FActiveEffect<UFXSystemComponent*>> ActiveFXSystemComponents;
-	TArray<FActiveEffect<UAudioComponent*>> ActiveSoundComponents;
+	TArray<FActiveEffect<UFXSystemComponent>> ActiveFXSystemComponents;
+	TArray<FActiveEffect<UAudioComponent>> ActiveSoundComponents;
+	int32 NumInaudibleSounds;
+	int32 NumOverBudgetSounds;
+	int32 NumCulledVFX;
+	EEffectSignificance Significance;
+
+	/* Kept alive packs hold on to their components after they finish so they can be restarted in place */
+	bool bKeepAlive;
+
+	/* Socket each kept alive effect that was spawned at a socket location instead of attached is moved back to on restart */
+	TArray<FFollowingEffect> SocketBindings;
+
+	/* Sounds of a kept alive pack, replayed through our audibility and concurrency checks on restart */
+	TArray<FKeptAliveSound> KeptAliveSounds;
+
+	void AddActiveVFX(UFXSystemComponent* VFX, FGameplayTag AccessTag) { ActiveFXSystemComponents.Add( FActiveEffect<UFXSystemComponent>(VFX, AccessTag)); }
+	void AddActiveSound(UAudioComponent* Sound, FGameplayTag AccessTag) { ActiveSoundComponents.Add( FActiveEffect<UAudioComponent>(Sound, AccessTag)); }
+
+	/* Takes our pooled visual effects out of auto release, active packs throttle and deactivate them long after they spawned */
+	void HoldPooledVFX()
+	{
+		for(FActiveEffect<UFXSystemComponent>& Effect : ActiveFXSystemComponents)
+		{
+			HoldFromPool(Effect);
+		}
+	}
+
+	static void HoldFromPool(FActiveEffect<UFXSystemComponent>& Effect);
+
+	/* Returns a held component to its pool, immediately if it finished or once it completes otherwise */
+	static void ReleaseToPool(FActiveEffect<UFXSystemComponent>& Effect);
+
+	static void ReleaseToPool(UFXSystemComponent* Component);
+
+	/* Binds a kept alive effect to its socket if it was not attached to our attach component */
+	void AddSocketBinding(USceneComponent* Component, const FFXData& Data)
+	{
+		if(bKeepAlive && Component && Component->GetAttachParent() != AttachComponent.Get())
+		{
+			SocketBindings.Add(FFollowingEffect(Component, Data.AttachmentData.SocketName, Data.GetRelativeTransform()));
+		}
+	}
+
+	void AddKeptAliveSound(UAudioComponent* Sound, const FSFXData& Data)
+	{
+		if(bKeepAlive && Sound)
+		{
+			KeptAliveSounds.Add(FKeptAliveSound(Sound, Data));
+		}
+	}
+
+	/* Records the outcome of trying to spawn a visual effect, culled effects are counted instead of added */
+	void AddVFXResult(UFXSystemComponent* VFX, FGameplayTag AccessTag, bool bCulled)
+	{
+		if(bCulled)
+		{
+			++NumCulledVFX;
+			return;
+		}
+
+		AddActiveVFX(VFX, AccessTag);
+	}
 
-	void AddActiveVFX(UFXSystemComponent* VFX, FGameplayTag AccessTag) { ActiveFXSystemComponents.Add( FActiveEffect(VFX, AccessTag)); }
-	void AddActiveSound(UAudioComponent* Sound, FGameplayTag AccessTag) { ActiveSoundComponents.Add( FActiveEffect(Sound, AccessTag)); }
+	/* Records the outcome of trying to spawn a sound, only spawned sounds are added to our active sounds */
+	void AddSoundResult(UAudioComponent* Sound, FGameplayTag AccessTag, ESoundSpawnResult Result)
+	{
+		switch(Result)
+		{
+		case ESoundSpawnResult::Spawned: AddActiveSound(Sound, AccessTag); break;
+		case ESoundSpawnResult::Inaudible: ++NumInaudibleSounds; break;
+		case ESoundSpawnResult::OverBudget: ++NumOverBudgetSounds; break;
+		default: break;
+		}
+	}
 
 	bool HasVFX() const { return ActiveFXSystemComponents.Num() > 0; }
 	bool HasSFX() const { return ActiveSoundComponents.Num() > 0; }
 	bool IsValid() const { return Id > -1; }
 	bool IsActive() const { return IsValid() && (HasSFX() || HasVFX()); }
 
+	/* Returns the location of our attach component or first spawned effect, false if we have neither */
+	bool GetLocation(FVector& OutLocation) const
+	{
+		if(const USceneComponent* Component = AttachComponent.Get())
+		{
+			OutLocation = Component->GetComponentLocation();
+			return true;
+		}
+
+		for(const FActiveEffect<UFXSystemComponent>& Effect : ActiveFXSystemComponents)
+		{
+			if(const UFXSystemComponent* Component = Effect.Object.Get())
+			{
+				OutLocation = Component->GetComponentLocation();
+				return true;
+			}
+		}
+
+		for(const FActiveEffect<UAudioComponent>& Effect : ActiveSoundComponents)
+		{
+			if(const UAudioComponent* Component = Effect.Object.Get())
+			{
+				OutLocation = Component->GetComponentLocation();
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	/* True if any of our visual effects were rendered within the passed in number of seconds */
+	bool WasRecentlyRendered(float Tolerance) const
+	{
+		return ActiveFXSystemComponents.ContainsByPredicate([Tolerance](const FActiveEffect<UFXSystemComponent>& Effect)
+		{
+			return Effect.Object.IsValid() && Effect.Object->WasRecentlyRendered(Tolerance);
+		});
+	}
+
 	/* Creates a handle to this active effect using its id */
-	FActiveEffectPackHandle CreateHandle() const { return FActiveEffectPackHandle(Id, ActivationType); }
+	FActiveEffectPackHandle CreateHandle() const { return FActiveEffectPackHandle(Id, ActivationType, NumInaudibleSounds, NumOverBudgetSounds, NumCulledVFX); }
+
+	/* Creates an invalid handle that still reports why sounds in this pack were skipped */
+	FActiveEffectPackHandle CreateInactiveHandle() const { return FActiveEffectPackHandle(-1, EEffectActivationType::None, NumInaudibleSounds, NumOverBudgetSounds, NumCulledVFX); }
 
 	void Invalidate()
 	{
@@ -291,15 +696,48 @@ struct FActiveEffectPack
 		DeactivateSFXSystems();
 	}
 
+	/* Moves our still active components into the passed in array so they can be deactivated later, leaving this pack empty.
+	 * Finished components have nothing left to deactivate, held ones are returned to their pool right away */
+	void ReleaseComponents(TArray<FPendingDeactivation>& OutComponents)
+	{
+		OutComponents.Reserve(OutComponents.Num() + ActiveFXSystemComponents.Num() + ActiveSoundComponents.Num());
+
+		for(FActiveEffect<UFXSystemComponent>& Effect : ActiveFXSystemComponents)
+		{
+			UFXSystemComponent* Component = Effect.Object.Get();
+			if(Component && Component->IsActive())
+			{
+				OutComponents.Add(FPendingDeactivation(Component, Effect.bHeldFromPool));
+			}
+			else
+			{
+				ReleaseToPool(Effect);
+			}
+		}
+
+		for(const FActiveEffect<UAudioComponent>& Effect : ActiveSoundComponents)
+		{
+			UAudioComponent* Component = Effect.Object.Get();
+			if(Component && Component->IsActive())
+			{
+				OutComponents.Add(FPendingDeactivation(Component, false));
+			}
+		}
+
+		ActiveFXSystemComponents.Empty();
+		ActiveSoundComponents.Empty();
+	}
+
 	void DeactivateFXSystems()
 	{
 		if (ActiveFXSystemComponents.IsEmpty()) return;
 
-		for(const FActiveEffect<UFXSystemComponent*>& Effect : ActiveFXSystemComponents)
+		for(FActiveEffect<UFXSystemComponent>& Effect : ActiveFXSystemComponents)
 		{
-			if(Effect.Object)
+			if(UFXSystemComponent* Component = Effect.Object.Get())
 			{
-				Effect.Object->Deactivate();
+				Component->Deactivate();
+				ReleaseToPool(Effect);
 			}
 		}
 
@@ -310,11 +748,11 @@ struct FActiveEffectPack
 	{
 		if (ActiveSoundComponents.IsEmpty()) return;
 
-		for(const FActiveEffect<UAudioComponent*>& Effect: ActiveSoundComponents)
+		for(const FActiveEffect<UAudioComponent>& Effect: ActiveSoundComponents)
 		{
-			if(Effect.Object)
+			if(UAudioComponent* Component = Effect.Object.Get())
 			{
-				Effect.Object->Deactivate();
+				Component->Deactivate();
 			}
 		}
 